@@ -0,0 +1,310 @@
+// Benchmarks dos caminhos quentes do firmware, rodando no host.
+//
+//   bench [--smoke] [--min-ms=N] [filtro]
+//
+// Para cada caso: ns por operação e, por operação, bytes no I2C
+// (endereço + dados), palavras no FIFO da PIO, bytes escritos no TCP
+// (copiados / referenciados sem cópia), pbufs recebidos e alocações de
+// heap do código da aplicação. Antes de medir, uma operação isolada é
+// conferida (resposta, contadores esperados, nenhuma alocação); com
+// --smoke só essa conferência roda (é o teste do ctest).
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "inc/ssd1306.h"
+#include "inc/assets.h"
+#include "host_shim.h"
+#include "bench_app.h"
+
+// inc/neopixel.c (incluído em presentation.c)
+void npInit(uint pin, uint amount);
+void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
+void npWrite(void);
+
+#define NP_LEDS 25
+#define SEG_MSS 1460
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    void (*run)(void);       // uma operação
+    bool (*check)(void);     // depois de uma operação isolada
+    int64_t i2c_bytes;       // esperado por operação (-1: não confere)
+    int64_t pio_words;
+} bench_t;
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Display
+// ~~~~~~~~~~~~~~~~~~~~~
+static uint8_t frame[ssd1306_buffer_length];
+static struct render_area full_area = {
+    .start_column = 0,
+    .end_column   = ssd1306_width - 1,
+    .start_page   = 0,
+    .end_page     = ssd1306_n_pages - 1,
+};
+static ssd1306_t bm_display;
+static uint8_t bitmap[ssd1306_buffer_length];
+
+static void setup_display(void) {
+    calculate_render_area_buffer_length(&full_area);
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)(i * 37);
+        bitmap[i] = (uint8_t)(i * 11);
+    }
+    ssd1306_init_bm(&bm_display, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+}
+
+static void run_render(void) {
+    render_on_display(frame, &full_area);
+}
+
+static void run_draw_string(void) {
+    static char line[] = "TEMP 23.45 UMID ";
+    for (int y = 0; y < ssd1306_height; y += ssd1306_line_height) {
+        ssd1306_draw_string(frame, 0, y, line);
+    }
+}
+
+static void run_draw_bitmap(void) {
+    ssd1306_draw_bitmap(&bm_display, bitmap);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  NeoPixel
+// ~~~~~~~~~~~~~~~~~~~~~
+static void setup_np(void) {
+    npInit(7, NP_LEDS);
+    for (uint i = 0; i < NP_LEDS; i++) {
+        npSetLED(i, (uint8_t)(i * 10), 0x40, (uint8_t)(255 - i * 10));
+    }
+}
+
+static void run_np_write(void) {
+    npWrite();
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  JSON de /dados
+// ~~~~~~~~~~~~~~~~~~~~~
+static const char json_body[] =
+    "{\"dispositivo\": \"estacao-01\", \"temperatura\": 23.45, \"umidade\": 61.20, "
+    "\"hora\": \"2024-05-01T12:00:00\"}";
+static float json_temp, json_umid;
+static bool  json_ok;
+
+static void run_parse_json(void) {
+    json_ok = app_parse_json(json_body, &json_temp, &json_umid);
+}
+
+static bool check_parse_json(void) {
+    return json_ok && json_temp > 23.44f && json_temp < 23.46f && json_umid > 61.19f && json_umid < 61.21f;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  HTTP: conexão completa (accept, recepção, resposta, fechamento)
+// ~~~~~~~~~~~~~~~~~~~~~
+#define BROWSER_HEADERS \
+    "Host: 192.168.0.10\r\n" \
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0 Safari/537.36\r\n" \
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n" \
+    "Accept-Encoding: gzip, deflate\r\n" \
+    "Accept-Language: pt-BR,pt;q=0.9,en;q=0.8\r\n" \
+    "Connection: keep-alive\r\n"
+
+static const char req_index[]  = "GET / HTTP/1.1\r\n" BROWSER_HEADERS "\r\n";
+static const char req_status[] = "GET /api/status HTTP/1.1\r\n" BROWSER_HEADERS "\r\n";
+static char req_304[768];
+static const char req_identity[] =
+    "GET /app.js HTTP/1.1\r\nHost: 192.168.0.10\r\nAccept-Encoding: identity\r\n\r\n";
+
+static bool http_closed;
+
+static void http_request(const char *req, size_t seg, size_t per_recv) {
+    struct tcp_pcb *pcb = host_tcp_connect_client();
+    size_t len = strlen(req);
+    bool open = pcb != NULL;
+    for (size_t off = 0; open && off < len; off += per_recv) {
+        open = host_tcp_deliver(pcb, req + off, MIN(per_recv, len - off), seg);
+    }
+    http_closed = pcb && host_tcp_is_closed(pcb);
+}
+
+static void setup_http(void) {
+    const asset_t *js = asset_find("/app.js", 7);
+    snprintf(req_304, sizeof(req_304), "GET /app.js?v=1 HTTP/1.1\r\n" BROWSER_HEADERS "If-None-Match: %s\r\n\r\n",
+             js ? js->etag : "\"\"");
+}
+
+static void run_http_index(void) {
+    http_request(req_index, SEG_MSS, sizeof(req_index));
+}
+
+// Mesma requisição em 4 recepções, cada uma numa cadeia de 2 pbufs
+static void run_http_split(void) {
+    size_t quarter = (sizeof(req_index) + 3) / 4;
+    http_request(req_index, (quarter + 1) / 2, quarter);
+}
+
+static void run_http_304(void) {
+    http_request(req_304, SEG_MSS, sizeof(req_304));
+}
+
+static void run_http_identity(void) {
+    http_request(req_identity, SEG_MSS, sizeof(req_identity));
+}
+
+static void run_http_status(void) {
+    http_request(req_status, SEG_MSS, sizeof(req_status));
+}
+
+static bool response_has(const char *prefix, const char *needle) {
+    size_t len;
+    const char *r = host_tcp_captured(&len);
+    size_t plen = strlen(prefix);
+    if (!http_closed || len < plen || memcmp(r, prefix, plen) != 0) {
+        return false;
+    }
+    // Procura só no cabeçalho/corpo textual capturado
+    for (size_t i = 0; needle && i + strlen(needle) <= len; i++) {
+        if (memcmp(r + i, needle, strlen(needle)) == 0) {
+            return true;
+        }
+    }
+    return needle == NULL;
+}
+
+static bool check_http_index(void) {
+    const asset_t *a = asset_find("/", 1);
+    return a && response_has("HTTP/1.1 200 OK", "Content-Encoding: gzip") && g_host.tcp_referenced == a->len;
+}
+
+static bool check_http_304(void) {
+    return response_has("HTTP/1.1 304 Not Modified", NULL) && g_host.tcp_referenced == 0;
+}
+
+// Sem cópia descomprimida: quem recusa gzip recebe 406 e nenhum corpo
+static bool check_http_identity(void) {
+    return response_has("HTTP/1.1 406 Not Acceptable", NULL) && g_host.tcp_referenced == 0;
+}
+
+static bool check_http_status(void) {
+    return response_has("HTTP/1.1 200 OK", "\"temperatura\":");
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Execução
+// ~~~~~~~~~~~~~~~~~~~~~
+static const bench_t benches[] = {
+    // Quadro inteiro: 6 comandos (3 bytes cada) + 0x40 e 1024 bytes + endereço
+    { "render_on_display",       setup_display, run_render,      NULL, 6 * 3 + 1 + 1025, 0 },
+    { "ssd1306_draw_string/8x16", setup_display, run_draw_string, NULL, 0, 0 },
+    { "ssd1306_draw_bitmap",     setup_display, run_draw_bitmap, NULL, -1, 0 },
+    { "npWrite/25",              setup_np,      run_np_write,    NULL, 0, NP_LEDS * 3 },
+    { "parse_json",              NULL,          run_parse_json,  check_parse_json, 0, 0 },
+    { "http_callback/index",     setup_http,    run_http_index,  check_http_index, 0, 0 },
+    { "http_callback/index_split", setup_http,  run_http_split,  check_http_index, 0, 0 },
+    { "http_callback/304",       setup_http,    run_http_304,    check_http_304, 0, 0 },
+    { "http_callback/406",       setup_http,    run_http_identity, check_http_identity, 0, 0 },
+    { "http_callback/status",    setup_http,    run_http_status, check_http_status, 0, 0 },
+};
+
+static uint64_t now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+static bool verify(const bench_t *b) {
+    host_counters_reset();
+    b->run();
+    bool ok = true;
+    if (b->check && !b->check()) {
+        fprintf(stderr, "%s: resultado incorreto\n", b->name);
+        ok = false;
+    }
+    if (b->i2c_bytes >= 0 && g_host.i2c_bytes != (uint64_t)b->i2c_bytes) {
+        fprintf(stderr, "%s: %llu bytes no I2C, esperado %lld\n", b->name,
+                (unsigned long long)g_host.i2c_bytes, (long long)b->i2c_bytes);
+        ok = false;
+    }
+    if (b->pio_words >= 0 && g_host.pio_words != (uint64_t)b->pio_words) {
+        fprintf(stderr, "%s: %llu palavras na PIO, esperado %lld\n", b->name,
+                (unsigned long long)g_host.pio_words, (long long)b->pio_words);
+        ok = false;
+    }
+    if (g_host.allocs != 0) {
+        fprintf(stderr, "%s: %llu alocações de heap\n", b->name, (unsigned long long)g_host.allocs);
+        ok = false;
+    }
+    return ok;
+}
+
+// Dobra o lote até durar min_ns; os contadores são os do último lote
+static void measure(const bench_t *b, uint64_t min_ns) {
+    uint64_t n = 1, dt;
+    while (true) {
+        host_counters_reset();
+        uint64_t t0 = now_ns();
+        for (uint64_t i = 0; i < n; i++) {
+            b->run();
+        }
+        dt = now_ns() - t0;
+        if (dt >= min_ns || n >= (1ull << 32)) {
+            break;
+        }
+        n *= 2;
+    }
+    double ops = (double)n;
+    printf("%-28s %10llu %12.1f %12.1f %9.1f %10.1f %10.1f %7.2f %7.2f\n", b->name, (unsigned long long)n,
+           dt / ops, g_host.i2c_bytes / ops, g_host.pio_words / ops, g_host.tcp_copied / ops,
+           g_host.tcp_referenced / ops, g_host.pbufs_freed / ops, g_host.allocs / ops);
+}
+
+int main(int argc, char **argv) {
+    bool smoke = false;
+    uint64_t min_ms = 200;
+    const char *filter = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--smoke") == 0) {
+            smoke = true;
+        } else if (strncmp(argv[i], "--min-ms=", 9) == 0) {
+            min_ms = strtoull(argv[i] + 9, NULL, 10);
+        } else if (argv[i][0] != '-') {
+            filter = argv[i];
+        } else {
+            fprintf(stderr, "uso: %s [--smoke] [--min-ms=N] [filtro]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    app_init();
+    int failures = 0;
+    if (!smoke) {
+        printf("%-28s %10s %12s %12s %9s %10s %10s %7s %7s\n", "benchmark", "ops", "ns/op",
+               "i2c B/op", "pio w/op", "tcp cp/op", "tcp ref/op", "pbuf/op", "aloc/op");
+    }
+    for (size_t i = 0; i < count_of(benches); i++) {
+        const bench_t *b = &benches[i];
+        if (filter && !strstr(b->name, filter)) {
+            continue;
+        }
+        if (b->setup) {
+            b->setup();
+        }
+        if (!verify(b)) {
+            failures++;
+            continue;
+        }
+        if (smoke) {
+            printf("ok   %s\n", b->name);
+        } else {
+            measure(b, min_ms * 1000000u);
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+// O firmware inteiro num único arquivo: incluído aqui (com main
+// renomeado) para que os benchmarks alcancem as funções static
+#define main firmware_main
+#include "pico_w_wifi_complete_example.c"
+#undef main
+
+#include "bench_app.h"
+
+// O que main() faz antes do laço, sem Wi-Fi nem núcleo 1
+void app_init(void) {
+    log_init();
+    flash_store_mount(flash_store_pico_dev());
+    load_settings();
+    history_init();
+    pool_init(&g_http_pool);
+    pool_init(&g_fetch_pool);
+    start_http_server();
+}
+
+bool app_parse_json(const char *json, float *temp, float *umid) {
+    return parse_json(json, temp, umid);
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_APP_H
+#define BENCH_APP_H
+
+#include <stdbool.h>
+
+// Ponte para as funções static do firmware (bench_app.c)
+void app_init(void);
+bool app_parse_json(const char *json, float *temp, float *umid);
+
+#endif
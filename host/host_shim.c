@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "pico/async_context.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+#include "hardware/watchdog.h"
+#include "lwip/stats.h"
+#include "inc/flash_store_pico.h"
+#include "inc/flash_sim.h"
+#include "host_shim.h"
+
+host_counters_t g_host;
+
+void host_counters_reset(void) {
+    memset(&g_host, 0, sizeof(g_host));
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Relógio
+// ~~~~~~~~~~~~~~~~~~~~~
+uint64_t time_us_64(void) {
+    static struct timespec t0;
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    if (t0.tv_sec == 0 && t0.tv_nsec == 0) {
+        t0 = t;
+    }
+    int64_t ns = (int64_t)(t.tv_sec - t0.tv_sec) * 1000000000 + (t.tv_nsec - t0.tv_nsec);
+    return (uint64_t)ns / 1000;
+}
+
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms) {
+    fprintf(stderr, "host: watchdog_reboot()\n");
+    exit(1);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  I2C e PIO
+// ~~~~~~~~~~~~~~~~~~~~~
+struct i2c_inst { int id; };
+static struct i2c_inst i2c_insts[2] = { { 0 }, { 1 } };
+i2c_inst_t *i2c0 = &i2c_insts[0];
+i2c_inst_t *i2c1 = &i2c_insts[1];
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    g_host.i2c_transfers++;
+    g_host.i2c_bytes += len + 1; // + byte de endereço
+    return (int)len;
+}
+
+struct pio_hw { int id; };
+static struct pio_hw pio_insts[2] = { { 0 }, { 1 } };
+PIO pio0 = &pio_insts[0];
+PIO pio1 = &pio_insts[1];
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    g_host.pio_words++;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  async_context e cyw43
+// ~~~~~~~~~~~~~~~~~~~~~
+struct async_context { int unused; };
+static async_context_t host_ctx;
+
+bool async_context_add_at_time_worker_at(async_context_t *c, async_at_time_worker_t *w, absolute_time_t t) {
+    w->next_time = t;
+    return true;
+}
+
+bool async_context_add_at_time_worker_in_ms(async_context_t *c, async_at_time_worker_t *w, uint32_t ms) {
+    return async_context_add_at_time_worker_at(c, w, delayed_by_ms(get_absolute_time(), ms));
+}
+
+bool async_context_remove_at_time_worker(async_context_t *c, async_at_time_worker_t *w) {
+    return true;
+}
+
+bool async_context_add_when_pending_worker(async_context_t *c, async_when_pending_worker_t *w) {
+    return true;
+}
+
+void async_context_set_work_pending(async_context_t *c, async_when_pending_worker_t *w) {
+    w->work_pending = true;
+}
+
+cyw43_t cyw43_state;
+
+int cyw43_arch_init(void) { return 0; }
+void cyw43_arch_deinit(void) {}
+void cyw43_arch_enable_sta_mode(void) {}
+async_context_t *cyw43_arch_async_context(void) { return &host_ctx; }
+
+int cyw43_arch_wifi_connect_async(const char *ssid, const char *pw, uint32_t auth) {
+    return 0;
+}
+
+int cyw43_wifi_join(cyw43_t *self, size_t ssid_len, const uint8_t *ssid, size_t key_len, const uint8_t *key,
+                    uint32_t auth, const uint8_t *bssid, uint32_t channel) {
+    return 0;
+}
+
+int cyw43_wifi_leave(cyw43_t *self, int itf) { return 0; }
+int cyw43_wifi_link_status(cyw43_t *self, int itf) { return CYW43_LINK_DOWN; }
+int cyw43_wifi_get_bssid(cyw43_t *self, uint8_t bssid[6]) { return -1; }
+
+void netif_set_addr(struct netif *n, const ip4_addr_t *ip, const ip4_addr_t *mask, const ip4_addr_t *gw) {
+    n->ip_addr = *ip;
+    n->netmask = *mask;
+    n->gw = *gw;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  lwIP: pcbs simulados
+// ~~~~~~~~~~~~~~~~~~~~~
+const ip_addr_t ip_addr_any = { 0 };
+
+static struct stats_mem memp_stats[MEMP_MAX];
+struct stats_ lwip_stats = {
+    .memp = {
+        &memp_stats[0], &memp_stats[1], &memp_stats[2], &memp_stats[3],
+        &memp_stats[4], &memp_stats[5], &memp_stats[6],
+    },
+};
+
+#define HOST_MAX_PCBS 8
+#define HOST_MAX_PBUFS 64
+
+struct tcp_pcb {
+    bool used;
+    void *arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+};
+
+static struct tcp_pcb pcbs[HOST_MAX_PCBS];
+static struct tcp_pcb *listener;
+
+static char   capture[HOST_TCP_CAPTURE];
+static size_t capture_len;
+
+struct tcp_pcb *tcp_new(void) {
+    for (int i = 0; i < HOST_MAX_PCBS; i++) {
+        if (!pcbs[i].used) {
+            memset(&pcbs[i], 0, sizeof(pcbs[i]));
+            pcbs[i].used = true;
+            return &pcbs[i];
+        }
+    }
+    return NULL;
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) { return ERR_OK; }
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+    listener = pcb;
+    return pcb;
+}
+
+// O cliente de /dados nunca conecta: o fetch fica pendente
+err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, tcp_connected_fn connected) {
+    return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+    g_host.tcp_closes++;
+    pcb->used = false;
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    pcb->used = false;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) { pcb->arg = arg; }
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) { pcb->accept = accept; }
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) { pcb->recv = recv; }
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) {}
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) {}
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {}
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) {}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags) {
+    g_host.tcp_writes++;
+    if (apiflags & TCP_WRITE_FLAG_COPY) {
+        g_host.tcp_copied += len;
+    } else {
+        g_host.tcp_referenced += len;
+    }
+    size_t n = MIN((size_t)len, sizeof(capture) - capture_len);
+    memcpy(capture + capture_len, dataptr, n);
+    capture_len += n;
+    return ERR_OK;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) { return ERR_OK; }
+
+// Envio confirmado na hora: buffer e fila sempre livres
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) { return TCP_SND_BUF; }
+u16_t tcp_sndqueuelen(const struct tcp_pcb *pcb) { return 0; }
+
+u8_t pbuf_free(struct pbuf *p) {
+    u8_t n = 0;
+    for (; p; p = p->next) {
+        n++;
+    }
+    g_host.pbufs_freed += n;
+    return n;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset) {
+    u16_t copied = 0;
+    for (; p && copied < len; p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+        u16_t n = MIN((u16_t)(p->len - offset), (u16_t)(len - copied));
+        memcpy((uint8_t *)dataptr + copied, (const uint8_t *)p->payload + offset, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
+
+int ip4addr_aton(const char *cp, ip4_addr_t *addr) {
+    unsigned a, b, c, d;
+    if (sscanf(cp, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+        return 0;
+    }
+    addr->addr = a | b << 8 | c << 16 | (uint32_t)d << 24;
+    return 1;
+}
+
+struct tcp_pcb *host_tcp_connect_client(void) {
+    struct tcp_pcb *pcb = tcp_new();
+    if (!pcb || !listener || !listener->accept) {
+        return NULL;
+    }
+    capture_len = 0;
+    if (listener->accept(listener->arg, pcb, ERR_OK) != ERR_OK) {
+        return NULL;
+    }
+    return pcb;
+}
+
+bool host_tcp_deliver(struct tcp_pcb *pcb, const void *data, size_t len, size_t seg) {
+    static struct pbuf chain[HOST_MAX_PBUFS];
+    if (!pcb->used || !pcb->recv || len == 0 || seg == 0 || (len + seg - 1) / seg > HOST_MAX_PBUFS) {
+        return false;
+    }
+    size_t count = (len + seg - 1) / seg;
+    for (size_t i = 0; i < count; i++) {
+        size_t off = i * seg;
+        chain[i].payload = (uint8_t *)data + off;
+        chain[i].len = (u16_t)MIN(seg, len - off);
+        chain[i].tot_len = (u16_t)(len - off);
+        chain[i].next = i + 1 < count ? &chain[i + 1] : NULL;
+        chain[i].ref = 1;
+    }
+    pcb->recv(pcb->arg, pcb, &chain[0], ERR_OK);
+    return pcb->used;
+}
+
+bool host_tcp_is_closed(const struct tcp_pcb *pcb) {
+    return !pcb->used;
+}
+
+const char *host_tcp_captured(size_t *len) {
+    *len = capture_len;
+    return capture;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Flash: simulador em RAM (inc/flash_sim.c)
+// ~~~~~~~~~~~~~~~~~~~~~
+const flash_store_dev_t *flash_store_pico_dev(void) {
+    static uint8_t mem[FLASH_STORE_REGION_SIZE];
+    static flash_sim_t sim;
+    static flash_store_dev_t dev;
+    if (!dev.size) {
+        flash_sim_init(&sim, mem, sizeof(mem));
+        flash_sim_dev(&sim, &dev);
+    }
+    return &dev;
+}
+
+uint32_t flash_store_pico_stall_us(void) {
+    return 0;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Heap (ligado com -Wl,--wrap=malloc,...)
+// ~~~~~~~~~~~~~~~~~~~~~
+#if HOST_WRAP_HEAP
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void  __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) {
+    g_host.allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    g_host.allocs++;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    g_host.allocs++;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr) {
+        g_host.frees++;
+    }
+    __real_free(ptr);
+}
+#endif
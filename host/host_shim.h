@@ -0,0 +1,46 @@
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lwip/tcp.h"
+
+// =====================
+//  CONTADORES DO HOST
+// =====================
+// Tudo o que o firmware entregaria ao hardware passa pelos substitutos em
+// host/shim e é contado aqui: bytes no I2C, palavras no FIFO da PIO,
+// escritas no TCP e alocações de heap do código da aplicação.
+
+typedef struct {
+    uint64_t i2c_transfers;  // i2c_write_blocking()
+    uint64_t i2c_bytes;      // endereço + dados, como no barramento
+    uint64_t pio_words;      // pio_sm_put_blocking()
+    uint64_t tcp_writes;
+    uint64_t tcp_copied;     // bytes escritos com TCP_WRITE_FLAG_COPY
+    uint64_t tcp_referenced; // bytes escritos sem cópia
+    uint64_t tcp_closes;
+    uint64_t pbufs_freed;    // pbufs de recepção liberados pela aplicação
+    uint64_t allocs;         // malloc/calloc/realloc (ligação com --wrap)
+    uint64_t frees;
+} host_counters_t;
+
+extern host_counters_t g_host;
+
+void host_counters_reset(void);
+
+// Últimos bytes escritos no TCP (cabeçalho + começo do corpo)
+#define HOST_TCP_CAPTURE 2048
+const char *host_tcp_captured(size_t *len);
+
+// Cliente simulado: conecta no pcb em escuta (tcp_listen + tcp_accept)
+struct tcp_pcb *host_tcp_connect_client(void);
+
+// Entrega "len" bytes ao callback de recepção em pbufs de até "seg"
+// bytes (uma cadeia); devolve false se a aplicação já fechou o pcb
+bool host_tcp_deliver(struct tcp_pcb *pcb, const void *data, size_t len, size_t seg);
+
+bool host_tcp_is_closed(const struct tcp_pcb *pcb);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+// O armazenamento usa inc/flash_sim.c no host (ver host_shim.c)
+#define FLASH_SECTOR_SIZE 4096u
+#define FLASH_PAGE_SIZE   256u
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/stdlib.h"
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Barramento gravado: cada transação é contada em host_shim.h
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *i2c0;
+extern i2c_inst_t *i2c1;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int  i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+// Só o FIFO TX interessa: as palavras empurradas são contadas
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+extern PIO pio0;
+extern PIO pio1;
+
+typedef struct {
+    uint32_t clkdiv, execctrl, shiftctrl, pinctrl;
+} pio_sm_config;
+
+typedef struct {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+enum pio_fifo_join { PIO_FIFO_JOIN_NONE = 0, PIO_FIFO_JOIN_TX = 1, PIO_FIFO_JOIN_RX = 2 };
+
+static inline uint pio_add_program(PIO pio, const pio_program_t *prog) { (void)pio; (void)prog; return 0; }
+static inline int  pio_claim_unused_sm(PIO pio, bool required) { (void)pio; (void)required; return 0; }
+static inline void pio_gpio_init(PIO pio, uint pin) { (void)pio; (void)pin; }
+static inline void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin, uint count, bool out) {
+    (void)pio; (void)sm; (void)pin; (void)count; (void)out;
+}
+static inline void pio_sm_init(PIO pio, uint sm, uint offset, const pio_sm_config *c) {
+    (void)pio; (void)sm; (void)offset; (void)c;
+}
+static inline void pio_sm_set_enabled(PIO pio, uint sm, bool en) { (void)pio; (void)sm; (void)en; }
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint pin) { (void)c; (void)pin; }
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool right, bool autopull, uint threshold) {
+    (void)c; (void)right; (void)autopull; (void)threshold;
+}
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) { (void)c; (void)join; }
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) { (void)c; (void)div; }
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_HARDWARE_REGS_ADDRESSMAP_H
+#define HOST_HARDWARE_REGS_ADDRESSMAP_H
+
+#define XIP_BASE 0x10000000u
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// Um único thread no host: tudo roda como se fosse o núcleo 0
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline uint get_core_num(void) { return 0; }
+
+#endif
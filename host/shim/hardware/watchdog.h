@@ -0,0 +1,9 @@
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+
+#include "pico/stdlib.h"
+
+static inline bool watchdog_caused_reboot(void) { return false; }
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms);
+
+#endif
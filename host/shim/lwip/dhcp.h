@@ -0,0 +1,10 @@
+#ifndef HOST_LWIP_DHCP_H
+#define HOST_LWIP_DHCP_H
+
+#include "lwip/netif.h"
+
+static inline err_t dhcp_start(struct netif *n) { (void)n; return ERR_OK; }
+static inline void  dhcp_stop(struct netif *n) { (void)n; }
+static inline u8_t  dhcp_supplied_address(const struct netif *n) { (void)n; return 0; }
+
+#endif
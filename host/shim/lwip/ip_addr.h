@@ -0,0 +1,19 @@
+#ifndef HOST_LWIP_IP_ADDR_H
+#define HOST_LWIP_IP_ADDR_H
+
+#include "lwip/err.h"
+
+typedef struct {
+    u32_t addr;
+} ip_addr_t;
+typedef ip_addr_t ip4_addr_t;
+
+extern const ip_addr_t ip_addr_any;
+#define IP_ADDR_ANY (&ip_addr_any)
+
+#define ip4_addr_get_u32(a)    ((a)->addr)
+#define ip4_addr_set_u32(a, v) ((a)->addr = (v))
+
+int ip4addr_aton(const char *cp, ip4_addr_t *addr);
+
+#endif
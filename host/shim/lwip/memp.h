@@ -0,0 +1,15 @@
+#ifndef HOST_LWIP_MEMP_H
+#define HOST_LWIP_MEMP_H
+
+typedef enum {
+    MEMP_RAW_PCB,
+    MEMP_UDP_PCB,
+    MEMP_TCP_PCB,
+    MEMP_TCP_PCB_LISTEN,
+    MEMP_TCP_SEG,
+    MEMP_PBUF,
+    MEMP_PBUF_POOL,
+    MEMP_MAX
+} memp_t;
+
+#endif
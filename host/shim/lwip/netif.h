@@ -0,0 +1,18 @@
+#ifndef HOST_LWIP_NETIF_H
+#define HOST_LWIP_NETIF_H
+
+#include "lwip/ip_addr.h"
+
+struct netif {
+    ip_addr_t ip_addr;
+    ip_addr_t netmask;
+    ip_addr_t gw;
+};
+
+#define netif_ip4_addr(n)    (&(n)->ip_addr)
+#define netif_ip4_netmask(n) (&(n)->netmask)
+#define netif_ip4_gw(n)      (&(n)->gw)
+
+void netif_set_addr(struct netif *n, const ip4_addr_t *ip, const ip4_addr_t *mask, const ip4_addr_t *gw);
+
+#endif
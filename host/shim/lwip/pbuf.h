@@ -0,0 +1,18 @@
+#ifndef HOST_LWIP_PBUF_H
+#define HOST_LWIP_PBUF_H
+
+#include "lwip/err.h"
+
+// Cadeias montadas por host_tcp_deliver(); pbuf_free só conta
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+    u8_t  ref;
+};
+
+u8_t  pbuf_free(struct pbuf *p);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+#endif
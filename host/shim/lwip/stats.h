@@ -0,0 +1,25 @@
+#ifndef HOST_LWIP_STATS_H
+#define HOST_LWIP_STATS_H
+
+#include "lwip/err.h"
+#include "lwip/memp.h"
+#include "lwipopts.h"
+
+// Estatísticas zeradas: o formato do /metrics é exercitado mesmo assim
+struct stats_mem {
+    const char *name;
+    u16_t err;
+    u32_t avail;
+    u32_t used;
+    u32_t max;
+    u16_t illegal;
+};
+
+struct stats_ {
+    struct stats_mem mem;
+    struct stats_mem *memp[MEMP_MAX];
+};
+
+extern struct stats_ lwip_stats;
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef HOST_LWIP_TCP_H
+#define HOST_LWIP_TCP_H
+
+#include <stddef.h>
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+#include "lwipopts.h"
+
+// API raw do TCP sobre pcbs simulados: tcp_write() só conta bytes
+// (copiados ou referenciados) e o envio é confirmado na hora, então o
+// buffer de envio está sempre livre.
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, u16_t len);
+typedef err_t (*tcp_connected_fn)(void *arg, struct tcp_pcb *tpcb, err_t err);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+typedef void  (*tcp_err_fn)(void *arg, err_t err);
+
+struct tcp_pcb *tcp_new(void);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb);
+err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, tcp_connected_fn connected);
+err_t tcp_close(struct tcp_pcb *pcb);
+void  tcp_abort(struct tcp_pcb *pcb);
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_recved(struct tcp_pcb *pcb, u16_t len);
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb);
+u16_t tcp_sndqueuelen(const struct tcp_pcb *pcb);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef HOST_MALLOC_H
+#define HOST_MALLOC_H
+
+// O /metrics usa mallinfo() (newlib, no RP2040); na glibc ela está
+// obsoleta em favor de mallinfo2(), com os mesmos campos em size_t
+#include_next <malloc.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+struct host_mallinfo {
+    size_t arena;
+    size_t uordblks;
+};
+
+static inline struct host_mallinfo host_mallinfo(void) {
+    struct mallinfo2 m = mallinfo2();
+    return (struct host_mallinfo){ .arena = m.arena, .uordblks = m.uordblks };
+}
+#define mallinfo host_mallinfo
+#endif
+
+#endif
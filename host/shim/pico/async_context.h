@@ -0,0 +1,29 @@
+#ifndef HOST_PICO_ASYNC_CONTEXT_H
+#define HOST_PICO_ASYNC_CONTEXT_H
+
+#include "pico/stdlib.h"
+
+// Workers são só registrados; nada roda sozinho no host
+typedef struct async_context async_context_t;
+
+typedef struct async_work_on_timeout {
+    struct async_work_on_timeout *next;
+    void (*do_work)(async_context_t *context, struct async_work_on_timeout *timeout);
+    absolute_time_t next_time;
+    void *user_data;
+} async_at_time_worker_t;
+
+typedef struct async_when_pending_worker {
+    struct async_when_pending_worker *next;
+    void (*do_work)(async_context_t *context, struct async_when_pending_worker *worker);
+    bool work_pending;
+    void *user_data;
+} async_when_pending_worker_t;
+
+bool async_context_add_at_time_worker_at(async_context_t *c, async_at_time_worker_t *w, absolute_time_t t);
+bool async_context_add_at_time_worker_in_ms(async_context_t *c, async_at_time_worker_t *w, uint32_t ms);
+bool async_context_remove_at_time_worker(async_context_t *c, async_at_time_worker_t *w);
+bool async_context_add_when_pending_worker(async_context_t *c, async_when_pending_worker_t *w);
+void async_context_set_work_pending(async_context_t *c, async_when_pending_worker_t *w);
+
+#endif
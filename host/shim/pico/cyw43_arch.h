@@ -0,0 +1,43 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+#include "pico/stdlib.h"
+#include "pico/async_context.h"
+#include "lwip/tcp.h"
+#include "lwip/netif.h"
+
+// Wi-Fi sempre desassociado: o gerenciador fica tentando, sem efeito
+
+typedef struct {
+    struct netif netif[2];
+} cyw43_t;
+extern cyw43_t cyw43_state;
+
+#define CYW43_ITF_STA 0
+#define CYW43_AUTH_OPEN         0
+#define CYW43_AUTH_WPA2_AES_PSK 0x00400004
+#define CYW43_CHANNEL_NONE      0xFFFFFFFFu
+
+#define CYW43_LINK_DOWN    0
+#define CYW43_LINK_JOIN    1
+#define CYW43_LINK_NOIP    2
+#define CYW43_LINK_UP      3
+#define CYW43_LINK_FAIL    (-1)
+#define CYW43_LINK_NONET   (-2)
+#define CYW43_LINK_BADAUTH (-3)
+
+int  cyw43_arch_init(void);
+void cyw43_arch_deinit(void);
+void cyw43_arch_enable_sta_mode(void);
+int  cyw43_arch_wifi_connect_async(const char *ssid, const char *pw, uint32_t auth);
+async_context_t *cyw43_arch_async_context(void);
+static inline void cyw43_arch_lwip_begin(void) {}
+static inline void cyw43_arch_lwip_end(void) {}
+
+int cyw43_wifi_join(cyw43_t *self, size_t ssid_len, const uint8_t *ssid, size_t key_len, const uint8_t *key,
+                    uint32_t auth, const uint8_t *bssid, uint32_t channel);
+int cyw43_wifi_leave(cyw43_t *self, int itf);
+int cyw43_wifi_link_status(cyw43_t *self, int itf);
+int cyw43_wifi_get_bssid(cyw43_t *self, uint8_t bssid[6]);
+
+#endif
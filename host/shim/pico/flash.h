@@ -0,0 +1,15 @@
+#ifndef HOST_PICO_FLASH_H
+#define HOST_PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+#define PICO_OK 0
+
+static inline int flash_safe_execute(void (*fn)(void *), void *param, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    fn(param);
+    return PICO_OK;
+}
+static inline void flash_safe_execute_core_init(void) {}
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+#include "pico/stdlib.h"
+
+// O núcleo 1 não é lançado: os benchmarks chamam as funções diretamente
+static inline void multicore_launch_core1(void (*entry)(void)) { (void)entry; }
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_PICO_PLATFORM_H
+#define HOST_PICO_PLATFORM_H
+
+#include "pico/stdlib.h"
+
+// No host não há RAM que sobreviva ao reset: variável comum
+#define __uninitialized_ram(group) group
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HOST_PICO_STDIO_USB_H
+#define HOST_PICO_STDIO_USB_H
+
+#include <stdbool.h>
+
+static inline bool stdio_usb_connected(void) { return false; }
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto do pico/stdlib.h para o build no host (host/CMakeLists.txt):
+// tipos e macros do SDK, GPIO e alarmes inertes, relógio real do host.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#ifndef MIN
+#define MIN(a, b) ((b) < (a) ? (b) : (a))
+#define MAX(a, b) ((a) < (b) ? (b) : (a))
+#endif
+
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+// Relógio: microssegundos desde o início do processo (CLOCK_MONOTONIC)
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + ms * 1000ull; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+
+// Esperas não dormem: o benchmark mede só o código
+static inline void sleep_ms(uint32_t ms) { (void)ms; }
+static inline void sleep_us(uint64_t us) { (void)us; }
+static inline void tight_loop_contents(void) {}
+static inline void stdio_init_all(void) {}
+
+static inline void __wfe(void) {}
+static inline void __sev(void) {}
+static inline void __mem_fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static inline void __mem_fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+
+// GPIO
+#define GPIO_IN  0
+#define GPIO_OUT 1
+#define GPIO_FUNC_I2C 3
+#define GPIO_IRQ_EDGE_FALL 4u
+#define GPIO_IRQ_EDGE_RISE 8u
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+static inline void gpio_init(uint pin) { (void)pin; }
+static inline void gpio_set_dir(uint pin, bool out) { (void)pin; (void)out; }
+static inline void gpio_put(uint pin, bool v) { (void)pin; (void)v; }
+static inline bool gpio_get(uint pin) { (void)pin; return true; } // pull-up: solto
+static inline void gpio_pull_up(uint pin) { (void)pin; }
+static inline void gpio_set_function(uint pin, int fn) { (void)pin; (void)fn; }
+static inline void gpio_set_irq_enabled(uint pin, uint32_t ev, bool en) { (void)pin; (void)ev; (void)en; }
+static inline void gpio_set_irq_enabled_with_callback(uint pin, uint32_t ev, bool en, gpio_irq_callback_t cb) {
+    (void)pin; (void)ev; (void)en; (void)cb;
+}
+static inline void gpio_acknowledge_irq(uint pin, uint32_t ev) { (void)pin; (void)ev; }
+
+// Alarmes: aceitos e nunca disparados
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+typedef struct alarm_pool alarm_pool_t;
+static inline alarm_pool_t *alarm_pool_get_default(void) { return NULL; }
+static inline alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max) { (void)max; return NULL; }
+static inline alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t *p, uint64_t us, alarm_callback_t cb, void *ud, bool fire) {
+    (void)p; (void)us; (void)cb; (void)ud; (void)fire;
+    return 1;
+}
+static inline alarm_id_t alarm_pool_add_alarm_in_ms(alarm_pool_t *p, uint32_t ms, alarm_callback_t cb, void *ud, bool fire) {
+    (void)p; (void)ms; (void)cb; (void)ud; (void)fire;
+    return 1;
+}
+static inline bool alarm_pool_cancel_alarm(alarm_pool_t *p, alarm_id_t id) { (void)p; (void)id; return true; }
+static inline alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t cb, void *ud, bool fire) {
+    (void)us; (void)cb; (void)ud; (void)fire;
+    return 1;
+}
+
+#endif
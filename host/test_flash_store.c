@@ -0,0 +1,381 @@
+// Testes do flash_store (inc/flash_store.c) sobre o simulador de NOR em
+// RAM (inc/flash_sim.c):
+//   - rotação dos setores com realocação das chaves pela coleta de lixo
+//   - desgaste uniforme (sector_erases) e nenhuma gravação sem apagar
+//   - registro rasgado rejeitado pelo CRC e remontagem depois dele
+//   - queda de energia em cada operação de uma sequência de escritas
+//   - montagem que falha não deixa o armazenamento gravável
+
+#include <stdio.h>
+#include <string.h>
+#include "inc/flash_store.h"
+#include "inc/flash_sim.h"
+
+#define SECTORS     4
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define REGION_SIZE (SECTORS * FLASH_STORE_SECTOR_SIZE)
+
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static uint8_t mem[REGION_SIZE];
+static flash_sim_t sim;
+static flash_store_dev_t dev;
+
+// Registro de log de teste: número de sequência + padrão derivado dele
+typedef struct {
+    uint32_t seq;
+    uint8_t  fill[12];
+} rec_t;
+
+static rec_t make_rec(uint32_t seq) {
+    rec_t r = { .seq = seq };
+    memset(r.fill, (uint8_t)(seq * 7 + 1), sizeof(r.fill));
+    return r;
+}
+
+// Confere a sequência reproduzida: contígua, sem lixo, até "last"
+typedef struct {
+    uint32_t first, last, count;
+    bool     ok;
+} replay_t;
+
+static bool replay_cb(const void *data, uint16_t len, void *ctx) {
+    replay_t *r = (replay_t *)ctx;
+    rec_t rec;
+    if (len != sizeof(rec)) {
+        r->ok = false;
+        return false;
+    }
+    memcpy(&rec, data, sizeof(rec));
+    rec_t want = make_rec(rec.seq);
+    if (memcmp(&rec, &want, sizeof(rec)) != 0 || (r->count && rec.seq != r->last + 1)) {
+        r->ok = false;
+        return false;
+    }
+    if (!r->count) {
+        r->first = rec.seq;
+    }
+    r->last = rec.seq;
+    r->count++;
+    return true;
+}
+
+static replay_t replay(void) {
+    replay_t r = { .ok = true };
+    flash_store_log_replay(FS_LOG_HISTORY, replay_cb, &r);
+    return r;
+}
+
+static bool key_equals(uint8_t key, const char *want) {
+    char buf[FLASH_STORE_MAX_VALUE];
+    int n = flash_store_get(key, buf, sizeof(buf));
+    return n == (int)strlen(want) + 1 && memcmp(buf, want, n) == 0;
+}
+
+static void fresh(void) {
+    flash_sim_init(&sim, mem, sizeof(mem));
+    flash_sim_dev(&sim, &dev);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Rotação e coleta de lixo
+// ~~~~~~~~~~~~~~~~~~~~~
+static void test_rotation(void) {
+    fresh();
+    CHECK(flash_store_mount(&dev));
+    CHECK(flash_store_set(FS_KEY_WIFI_SSID, "rede", 5));
+    CHECK(flash_store_set(FS_KEY_WIFI_PASS, "segredo", 8));
+    CHECK(flash_store_set(FS_KEY_LED_STATE, "1", 2));
+
+    // Várias voltas no anel: as chaves só sobrevivem se forem realocadas
+    uint32_t n = 5 * SECTORS * FLASH_STORE_SECTOR_SIZE / (sizeof(rec_t) + 8);
+    for (uint32_t i = 0; i < n; i++) {
+        rec_t r = make_rec(i);
+        CHECK(flash_store_append(FS_LOG_HISTORY, &r, sizeof(r)));
+    }
+    CHECK(flash_store_flush());
+
+    CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+    CHECK(key_equals(FS_KEY_WIFI_PASS, "segredo"));
+    CHECK(key_equals(FS_KEY_LED_STATE, "1"));
+    replay_t r = replay();
+    CHECK(r.ok && r.count > 0 && r.last == n - 1);
+
+    // Cada setor é apagado uma vez por volta
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (uint32_t s = 0; s < SECTORS; s++) {
+        lo = sim.sector_erases[s] < lo ? sim.sector_erases[s] : lo;
+        hi = sim.sector_erases[s] > hi ? sim.sector_erases[s] : hi;
+    }
+    CHECK(lo >= 4 && hi - lo <= 1);
+    CHECK(sim.violations == 0);
+
+    // Remontagem reconstrói o índice e o fim do log
+    flash_store_stats_t before, after;
+    flash_store_get_stats(&before);
+    CHECK(flash_store_mount(&dev));
+    flash_store_get_stats(&after);
+    CHECK(after.head_sector == before.head_sector && after.used_bytes == before.used_bytes);
+    CHECK(after.keys == 3);
+    CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+    CHECK(key_equals(FS_KEY_LED_STATE, "1"));
+    replay_t r2 = replay();
+    CHECK(r2.ok && r2.first == r.first && r2.last == r.last);
+
+    // Apagar sobrevive à remontagem
+    CHECK(flash_store_del(FS_KEY_LED_STATE));
+    CHECK(flash_store_mount(&dev));
+    CHECK(flash_store_get(FS_KEY_LED_STATE, NULL, 0) == -1);
+    CHECK(key_equals(FS_KEY_WIFI_PASS, "segredo"));
+    CHECK(sim.violations == 0);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Registro rasgado
+// ~~~~~~~~~~~~~~~~~~~~~
+static void test_torn_record(void) {
+    fresh();
+    CHECK(flash_store_mount(&dev));
+    CHECK(flash_store_set(FS_KEY_WIFI_SSID, "rede", 5));
+    for (uint32_t i = 0; i < 10; i++) {
+        rec_t r = make_rec(i);
+        CHECK(flash_store_append(FS_LOG_HISTORY, &r, sizeof(r)));
+    }
+    CHECK(flash_store_flush());
+
+    // Queda durante a gravação do último registro: o fim dos dados
+    // ficou apagado (0xFF) e o CRC não confere
+    flash_store_stats_t st;
+    flash_store_get_stats(&st);
+    uint32_t end = st.head_sector * FLASH_STORE_SECTOR_SIZE + st.used_bytes;
+    memset(mem + end - 4, 0xFF, 4);
+
+    CHECK(flash_store_mount(&dev));
+    replay_t r = replay();
+    CHECK(r.ok && r.first == 0 && r.last == 8);
+    CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+
+    // O setor com o registro rasgado não recebe mais nada: a próxima
+    // escrita abre outro setor, sem gravar por cima de bits já zerados
+    flash_store_get_stats(&st);
+    uint32_t torn_sector = st.head_sector;
+    rec_t next = make_rec(9);
+    CHECK(flash_store_append(FS_LOG_HISTORY, &next, sizeof(next)));
+    CHECK(flash_store_set(FS_KEY_LED_STATE, "0", 2));
+    flash_store_get_stats(&st);
+    CHECK(st.head_sector != torn_sector);
+    CHECK(sim.violations == 0);
+
+    CHECK(flash_store_mount(&dev));
+    CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+    CHECK(key_equals(FS_KEY_LED_STATE, "0"));
+    r = replay();
+    CHECK(r.ok && r.last == 9);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Queda de energia
+// ~~~~~~~~~~~~~~~~~~~~~
+// Dispositivo que "perde a energia" depois de "budget" operações: da
+// gravação interrompida só os primeiros "torn" bytes chegam à flash e as
+// operações seguintes não têm efeito
+typedef struct {
+    const flash_store_dev_t *inner;
+    uint32_t budget;
+    uint32_t torn;
+    bool     dead;
+} power_t;
+
+static void power_read(void *ctx, uint32_t off, void *dst, size_t len) {
+    power_t *p = (power_t *)ctx;
+    p->inner->read(p->inner->ctx, off, dst, len);
+}
+
+static bool power_program(void *ctx, uint32_t off, const uint8_t *src, size_t len) {
+    power_t *p = (power_t *)ctx;
+    if (p->dead) {
+        return false;
+    }
+    if (p->budget-- == 0) {
+        uint8_t part[FLASH_STORE_PAGE_SIZE];
+        size_t n = p->torn < len ? p->torn : len;
+        memcpy(part, src, n);
+        memset(part + n, 0xFF, len - n);
+        p->inner->program(p->inner->ctx, off, part, len);
+        p->dead = true;
+        return false;
+    }
+    return p->inner->program(p->inner->ctx, off, src, len);
+}
+
+static bool power_erase(void *ctx, uint32_t off) {
+    power_t *p = (power_t *)ctx;
+    if (p->dead || p->budget-- == 0) {
+        p->dead = true;
+        return false;
+    }
+    return p->inner->erase(p->inner->ctx, off);
+}
+
+static void test_power_loss(void) {
+    static uint8_t base[REGION_SIZE];
+
+    // Imagem inicial: chaves gravadas e o setor atual quase cheio, para
+    // que a sequência abaixo passe pela rotação e pela coleta de lixo
+    fresh();
+    CHECK(flash_store_mount(&dev));
+    CHECK(flash_store_set(FS_KEY_WIFI_SSID, "rede", 5));
+    CHECK(flash_store_set(FS_KEY_WIFI_PASS, "segredo", 8));
+    uint32_t seq = 0;
+    for (flash_store_stats_t st = { 0 }; st.sectors == 0 || st.head_sector < SECTORS - 1; seq++) {
+        rec_t r = make_rec(seq);
+        CHECK(flash_store_append(FS_LOG_HISTORY, &r, sizeof(r)));
+        flash_store_get_stats(&st);
+    }
+    CHECK(flash_store_flush());
+    memcpy(base, mem, sizeof(base));
+    uint32_t base_seq = seq;
+
+    // Cada ponto de queda com nada, um pedaço e metade da página gravados
+    static const uint32_t tears[] = { 0, 24, FLASH_STORE_PAGE_SIZE / 2 };
+    bool finished = false;
+    for (uint32_t run = 0; !finished && run < 200 * count_of(tears); run++) {
+        uint32_t budget = run / count_of(tears);
+        memcpy(mem, base, sizeof(mem));
+        power_t pw = { .inner = &dev, .budget = budget, .torn = tears[run % count_of(tears)] };
+        flash_store_dev_t pdev = dev;
+        pdev.ctx     = &pw;
+        pdev.read    = power_read;
+        pdev.program = power_program;
+        pdev.erase   = power_erase;
+
+        // Escritas até a energia cair; guarda o último valor confirmado
+        char led = 'a', committed = 0;
+        uint32_t appended = base_seq;
+        CHECK(flash_store_mount(&pdev) || pw.dead);
+        for (int i = 0; i < 600 && !pw.dead; i++) {
+            rec_t r = make_rec(appended);
+            if (flash_store_append(FS_LOG_HISTORY, &r, sizeof(r))) {
+                appended++;
+            }
+            if (i % 20 == 0) {
+                char v[2] = { led, 0 };
+                if (flash_store_set(FS_KEY_LED_STATE, v, 2)) {
+                    committed = led;
+                }
+                led = led == 'z' ? 'a' : led + 1;
+            }
+        }
+        finished = !pw.dead;
+
+        // Religa: tudo o que foi confirmado continua lá
+        uint32_t violations = sim.violations;
+        CHECK(flash_store_mount(&dev));
+        CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+        CHECK(key_equals(FS_KEY_WIFI_PASS, "segredo"));
+        char v[FLASH_STORE_MAX_VALUE];
+        int n = flash_store_get(FS_KEY_LED_STATE, v, sizeof(v));
+        if (committed) {
+            // O valor em gravação na queda pode ou não ter entrado
+            char inflight = committed == 'z' ? 'a' : committed + 1;
+            CHECK(n == 2 && (v[0] == committed || v[0] == inflight));
+        }
+        replay_t r = replay();
+        CHECK(r.ok && r.count > 0 && r.last < appended + 1);
+
+        // E o armazenamento continua gravável: uma volta inteira no anel
+        // depois da queda (uma coleta interrompida precisa ter sido
+        // concluída na montagem, senão o setor com as chaves é apagado)
+        CHECK(flash_store_set(FS_KEY_LED_STATE, "!", 2));
+        for (uint32_t i = 0; i < SECTORS * FLASH_STORE_SECTOR_SIZE / (sizeof(rec_t) + 8); i++) {
+            rec_t rec = make_rec(r.last + 1 + i);
+            CHECK(flash_store_append(FS_LOG_HISTORY, &rec, sizeof(rec)));
+        }
+        CHECK(flash_store_mount(&dev));
+        CHECK(key_equals(FS_KEY_LED_STATE, "!"));
+        CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+        CHECK(key_equals(FS_KEY_WIFI_PASS, "segredo"));
+        CHECK(replay().ok);
+        CHECK(sim.violations == violations);
+        if (failures) {
+            fprintf(stderr, "  (queda depois de %u operações, %u bytes da página gravados)\n",
+                    (unsigned)budget, (unsigned)pw.torn);
+            return;
+        }
+    }
+    CHECK(finished);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Montagem com falha
+// ~~~~~~~~~~~~~~~~~~~~~
+static bool is_blank(void) {
+    for (size_t i = 0; i < sizeof(mem); i++) {
+        if (mem[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void expect_unmounted(void) {
+    rec_t r = make_rec(0);
+    CHECK(!flash_store_set(FS_KEY_WIFI_SSID, "outra", 6));
+    CHECK(!flash_store_append(FS_LOG_HISTORY, &r, sizeof(r)));
+    CHECK(!flash_store_flush());
+    CHECK(flash_store_get(FS_KEY_WIFI_SSID, NULL, 0) == -1);
+    CHECK(replay().count == 0);
+}
+
+static void test_failed_mount(void) {
+    // Armazenamento montado e com chaves antes da falha
+    fresh();
+    CHECK(flash_store_mount(&dev));
+    CHECK(flash_store_set(FS_KEY_WIFI_SSID, "rede", 5));
+
+    // Região em branco num dispositivo que recusa gravar (ex.: o outro
+    // núcleo ainda não pode ser pausado): a formatação falha
+    fresh();
+    power_t pw = { .inner = &dev, .dead = true };
+    flash_store_dev_t pdev = dev;
+    pdev.ctx     = &pw;
+    pdev.read    = power_read;
+    pdev.program = power_program;
+    pdev.erase   = power_erase;
+    CHECK(!flash_store_mount(&pdev));
+    expect_unmounted();
+    CHECK(!flash_store_format());
+    CHECK(is_blank());
+
+    // Região pequena demais
+    flash_store_dev_t small = dev;
+    small.size = 2 * FLASH_STORE_SECTOR_SIZE;
+    CHECK(!flash_store_mount(&small));
+    expect_unmounted();
+    CHECK(is_blank());
+
+    // Uma nova montagem bem-sucedida volta a aceitar escritas
+    CHECK(flash_store_mount(&dev));
+    CHECK(flash_store_set(FS_KEY_WIFI_SSID, "rede", 5));
+    CHECK(key_equals(FS_KEY_WIFI_SSID, "rede"));
+}
+
+int main(void) {
+    test_rotation();
+    test_torn_record();
+    test_power_loss();
+    test_failed_mount();
+    if (failures) {
+        fprintf(stderr, "%d falha(s)\n", failures);
+        return 1;
+    }
+    printf("flash_store: ok\n");
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "ipc.h"
+#include "app_state.h"
+
+static seqlock_t   net_lock;
+static net_state_t net_state;
+
+static seqlock_t   ui_lock;
+static ui_state_t  ui_state;
+
+void app_state_publish_net(const net_state_t *s) {
+    seqlock_write_begin(&net_lock);
+    net_state = *s;
+    seqlock_write_end(&net_lock);
+}
+
+void app_state_read_net(net_state_t *out) {
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&net_lock);
+        *out = net_state;
+    } while (seqlock_read_retry(&net_lock, seq));
+}
+
+// Muda a cada publicação: permite detectar novidades sem copiar o estado
+uint32_t app_state_net_version(void) {
+    return net_lock.seq;
+}
+
+void app_state_publish_ui(const ui_state_t *s) {
+    seqlock_write_begin(&ui_lock);
+    ui_state = *s;
+    seqlock_write_end(&ui_lock);
+}
+
+void app_state_read_ui(ui_state_t *out) {
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&ui_lock);
+        *out = ui_state;
+    } while (seqlock_read_retry(&ui_lock, seq));
+}
@@ -0,0 +1,40 @@
+#ifndef APP_STATE_H
+#define APP_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "buttons.h"
+
+// =====================
+//  ESTADO COMPARTILHADO
+// =====================
+// Instantâneos protegidos por seqlock, cada um com um único escritor:
+//   - net_state_t: escrito pelo núcleo 0 (rede, dados remotos, LED), só
+//     dentro do async_context (fora dele, com cyw43_arch_lwip_begin):
+//     um leitor numa IRQ que interrompesse outro escritor no mesmo
+//     núcleo esperaria para sempre
+//   - ui_state_t:  escrito pelo núcleo 1 (botões)
+// Leitores em qualquer núcleo copiam o instantâneo sem bloquear o escritor.
+
+typedef struct {
+    float    temperatura;
+    float    umidade;
+    uint32_t ip;      // IPv4 em ordem de rede (0 = sem conexão)
+    bool     led_on;
+    uint32_t http_requests;
+} net_state_t;
+
+typedef struct {
+    bool           pressed[BUTTONS_MAX];
+    bool           seen[BUTTONS_MAX];
+    button_event_t last[BUTTONS_MAX];
+} ui_state_t;
+
+void     app_state_publish_net(const net_state_t *s);
+void     app_state_read_net(net_state_t *out);
+uint32_t app_state_net_version(void);
+
+void     app_state_publish_ui(const ui_state_t *s);
+void     app_state_read_ui(ui_state_t *out);
+
+#endif
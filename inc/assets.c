@@ -0,0 +1,36 @@
+#include <string.h>
+#include "assets.h"
+
+// Compara "path" (len bytes, sem terminador) com um caminho da tabela
+static int path_cmp(const char *path, size_t len, const char *entry) {
+    int r = strncmp(path, entry, len);
+    if (r != 0) {
+        return r;
+    }
+    return entry[len] == '\0' ? 0 : -1;
+}
+
+const asset_t *asset_find(const char *path, size_t len) {
+    const char *q = memchr(path, '?', len);
+    if (q) {
+        len = q - path;
+    }
+    if (len == 1 && path[0] == '/') {
+        path = "/index.html";
+        len = 11;
+    }
+    unsigned lo = 0, hi = g_assets_count;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        int r = path_cmp(path, len, g_assets[mid].path);
+        if (r == 0) {
+            return &g_assets[mid];
+        }
+        if (r < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,33 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =====================
+//  ARQUIVOS ESTÁTICOS (interface web)
+// =====================
+// A pasta web/ é comprimida com gzip na compilação (tools/gen_assets.py)
+// e vira uma tabela const na flash, ordenada pelo caminho. Os arquivos
+// são enviados como estão (Content-Encoding: gzip), direto da flash;
+// cliente cujo Accept-Encoding recusa gzip recebe 406.
+
+typedef struct {
+    const char    *path;      // "/app.js"
+    const char    *mime;
+    const uint8_t *data;      // corpo já comprimido
+    uint32_t       len;
+    uint32_t       raw_len;   // tamanho descomprimido
+    const char    *etag;      // hash do conteúdo, já entre aspas
+    bool           immutable; // referenciado com ?v=<hash>: cache longo
+} asset_t;
+
+// Tabela gerada (assets_data.c no diretório de build)
+extern const asset_t  g_assets[];
+extern const unsigned g_assets_count;
+
+// Caminho da requisição, sem a query; "/" é /index.html. NULL se não existe.
+const asset_t *asset_find(const char *path, size_t len);
+
+#endif
@@ -0,0 +1,232 @@
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "ipc.h"
+#include "buttons.h"
+
+typedef enum {
+    GS_IDLE = 0,
+    GS_PRESSED,      // pressionado, aguardando soltar ou pressão longa
+    GS_WAIT_DOUBLE,  // soltou após um clique, aguardando o segundo
+    GS_SECOND_PRESS, // segundo toque dentro da janela de clique duplo
+    GS_HOLDING,      // pressão longa em andamento
+} gesture_state_t;
+
+typedef struct {
+    uint     pin;
+    bool     stable;       // nível confirmado (true = pressionado)
+    bool     debouncing;
+    uint32_t edge_us;      // primeira borda ainda não confirmada
+    gesture_state_t state;
+    uint32_t deadline_us;  // próximo timeout da máquina de gestos
+} button_t;
+
+static button_t      buttons[BUTTONS_MAX];
+static uint          n_buttons;
+static void        (*notify_cb)(void);
+static alarm_pool_t *debounce_pool;
+
+// Fila SPSC: produtor = alarme de debounce; consumidor = buttons_process
+static button_event_t queue_buf[BUTTONS_QUEUE_LEN];
+static spsc_queue_t   queue;
+
+static struct {
+    button_listener_t fn;
+    void *ctx;
+} listeners[BUTTONS_MAX_LISTENERS];
+static uint n_listeners;
+
+static bool read_pressed(const button_t *b) {
+    return !gpio_get(b->pin); // pull-up: nível baixo = pressionado
+}
+
+static int64_t debounce_alarm_cb(alarm_id_t id, void *user_data);
+
+static void start_debounce(uint8_t idx, uint32_t t_us) {
+    button_t *b = &buttons[idx];
+    b->debouncing = true;
+    b->edge_us = t_us;
+    gpio_set_irq_enabled(b->pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, false);
+    if (alarm_pool_add_alarm_in_us(debounce_pool, BUTTONS_DEBOUNCE_US, debounce_alarm_cb, (void *)(uintptr_t)idx, true) < 0) {
+        // Sem alarmes livres: confirma direto
+        debounce_alarm_cb(0, (void *)(uintptr_t)idx);
+    }
+}
+
+// Fim da janela de debounce: confirma o nível e reativa a IRQ do pino
+static int64_t debounce_alarm_cb(alarm_id_t id, void *user_data) {
+    uint8_t idx = (uint8_t)(uintptr_t)user_data;
+    button_t *b = &buttons[idx];
+    bool level = read_pressed(b);
+    if (level != b->stable) {
+        b->stable = level;
+        button_event_t ev = { .t_us = b->edge_us, .button = idx, .gesture = level ? BUTTON_PRESS : BUTTON_RELEASE };
+        spsc_push(&queue, &ev);
+        if (notify_cb) {
+            notify_cb();
+        }
+    }
+    b->debouncing = false;
+    gpio_acknowledge_irq(b->pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE);
+    gpio_set_irq_enabled(b->pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true);
+
+    // Mudou de novo enquanto a IRQ estava desligada: nova janela
+    if (read_pressed(b) != b->stable) {
+        start_debounce(idx, time_us_32());
+    }
+    return 0;
+}
+
+static void gpio_irq_cb(uint gpio, uint32_t events) {
+    uint32_t now = time_us_32();
+    for (uint i = 0; i < n_buttons; i++) {
+        if (buttons[i].pin == gpio && !buttons[i].debouncing) {
+            start_debounce(i, now);
+        }
+    }
+}
+
+void buttons_init(const uint *pins, uint count, void (*notify)(void), alarm_pool_t *pool) {
+    n_buttons = count < BUTTONS_MAX ? count : BUTTONS_MAX;
+    notify_cb = notify;
+    debounce_pool = pool ? pool : alarm_pool_get_default();
+    spsc_init(&queue, queue_buf, sizeof(button_event_t), BUTTONS_QUEUE_LEN);
+    for (uint i = 0; i < n_buttons; i++) {
+        button_t *b = &buttons[i];
+        b->pin = pins[i];
+        gpio_init(b->pin);
+        gpio_set_dir(b->pin, GPIO_IN);
+        gpio_pull_up(b->pin);
+        b->stable = read_pressed(b);
+        b->state = GS_IDLE;
+        gpio_set_irq_enabled_with_callback(b->pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, gpio_irq_cb);
+    }
+}
+
+bool buttons_subscribe(button_listener_t fn, void *ctx) {
+    if (n_listeners >= BUTTONS_MAX_LISTENERS) {
+        return false;
+    }
+    listeners[n_listeners].fn  = fn;
+    listeners[n_listeners].ctx = ctx;
+    n_listeners++;
+    return true;
+}
+
+static void emit(uint8_t button, button_gesture_t gesture, uint32_t t_us) {
+    button_event_t ev = { .t_us = t_us, .button = button, .gesture = gesture };
+    for (uint i = 0; i < n_listeners; i++) {
+        listeners[i].fn(&ev, listeners[i].ctx);
+    }
+}
+
+static bool expired(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+// Máquina de gestos: alimentada pelas bordas confirmadas
+static void gesture_edge(uint8_t idx, const button_event_t *ev) {
+    button_t *b = &buttons[idx];
+    bool pressed = (ev->gesture == BUTTON_PRESS);
+    emit(idx, (button_gesture_t)ev->gesture, ev->t_us);
+
+    switch (b->state) {
+        case GS_IDLE:
+            if (pressed) {
+                b->state = GS_PRESSED;
+                b->deadline_us = ev->t_us + BUTTONS_LONG_MS * 1000;
+            }
+            break;
+        case GS_PRESSED:
+            if (!pressed) {
+                b->state = GS_WAIT_DOUBLE;
+                b->deadline_us = ev->t_us + BUTTONS_DOUBLE_MS * 1000;
+            }
+            break;
+        case GS_WAIT_DOUBLE:
+            if (pressed) {
+                b->state = GS_SECOND_PRESS;
+                b->deadline_us = ev->t_us + BUTTONS_LONG_MS * 1000;
+            }
+            break;
+        case GS_SECOND_PRESS:
+            if (!pressed) {
+                emit(idx, BUTTON_DOUBLE_CLICK, ev->t_us);
+                b->state = GS_IDLE;
+            }
+            break;
+        case GS_HOLDING:
+            if (!pressed) {
+                b->state = GS_IDLE;
+            }
+            break;
+    }
+}
+
+// Máquina de gestos: timeouts
+static void gesture_timeout(uint8_t idx, uint32_t now) {
+    button_t *b = &buttons[idx];
+    if (b->state == GS_IDLE || !expired(now, b->deadline_us)) {
+        return;
+    }
+    switch (b->state) {
+        case GS_WAIT_DOUBLE:
+            emit(idx, BUTTON_CLICK, b->deadline_us - BUTTONS_DOUBLE_MS * 1000);
+            b->state = GS_IDLE;
+            break;
+        case GS_PRESSED:
+        case GS_SECOND_PRESS:
+            emit(idx, BUTTON_LONG_PRESS, b->deadline_us);
+            b->state = GS_HOLDING;
+            b->deadline_us += BUTTONS_REPEAT_MS * 1000;
+            break;
+        case GS_HOLDING:
+            emit(idx, BUTTON_HOLD_REPEAT, b->deadline_us);
+            b->deadline_us += BUTTONS_REPEAT_MS * 1000;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t buttons_process(void) {
+    button_event_t ev;
+    while (spsc_pop(&queue, &ev)) {
+        // Timeouts vencidos antes desta borda são tratados primeiro
+        gesture_timeout(ev.button, ev.t_us);
+        gesture_edge(ev.button, &ev);
+    }
+
+    uint32_t now = time_us_32();
+    uint32_t next_ms = 0;
+    for (uint i = 0; i < n_buttons; i++) {
+        gesture_timeout(i, now);
+        if (buttons[i].state != GS_IDLE) {
+            int32_t left_us = (int32_t)(buttons[i].deadline_us - now);
+            uint32_t ms = left_us > 0 ? (uint32_t)(left_us + 999) / 1000 : 1;
+            if (next_ms == 0 || ms < next_ms) {
+                next_ms = ms;
+            }
+        }
+    }
+    return next_ms;
+}
+
+bool buttons_is_pressed(uint8_t button) {
+    return button < n_buttons && buttons[button].stable;
+}
+
+uint32_t buttons_dropped(void) {
+    return queue.dropped;
+}
+
+const char *buttons_gesture_name(button_gesture_t g) {
+    switch (g) {
+        case BUTTON_PRESS:        return "press";
+        case BUTTON_RELEASE:      return "release";
+        case BUTTON_CLICK:        return "click";
+        case BUTTON_DOUBLE_CLICK: return "double_click";
+        case BUTTON_LONG_PRESS:   return "long_press";
+        case BUTTON_HOLD_REPEAT:  return "hold_repeat";
+    }
+    return "?";
+}
@@ -0,0 +1,58 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// =====================
+//  BOTÕES (IRQ + GESTOS)
+// =====================
+// A borda é capturada na IRQ do GPIO (timestamp em us) e confirmada por
+// um alarme após BUTTONS_DEBOUNCE_US. Eventos confirmados entram num
+// buffer circular sem lock (produtor: IRQ; consumidor: buttons_process),
+// onde são convertidos em gestos e entregues aos assinantes.
+
+#define BUTTONS_MAX            2
+#define BUTTONS_QUEUE_LEN      32   // potência de 2
+#define BUTTONS_MAX_LISTENERS  4
+
+#define BUTTONS_DEBOUNCE_US    5000
+#define BUTTONS_DOUBLE_MS      300  // janela para o segundo clique
+#define BUTTONS_LONG_MS        800  // pressão longa
+#define BUTTONS_REPEAT_MS      200  // repetição enquanto segurado
+
+typedef enum {
+    BUTTON_PRESS = 0,     // borda confirmada (pressionado)
+    BUTTON_RELEASE,       // borda confirmada (solto)
+    BUTTON_CLICK,
+    BUTTON_DOUBLE_CLICK,
+    BUTTON_LONG_PRESS,
+    BUTTON_HOLD_REPEAT,
+} button_gesture_t;
+
+typedef struct {
+    uint32_t t_us;     // instante da primeira borda
+    uint8_t  button;   // índice em buttons_init()
+    uint8_t  gesture;  // button_gesture_t
+} button_event_t;
+
+typedef void (*button_listener_t)(const button_event_t *ev, void *ctx);
+
+// "notify" é chamado da IRQ quando há eventos novos para processar.
+// As IRQs de GPIO ficam no núcleo que chama; o debounce usa "pool"
+// (NULL = pool padrão do núcleo 0).
+void buttons_init(const uint *pins, uint count, void (*notify)(void), alarm_pool_t *pool);
+
+bool buttons_subscribe(button_listener_t fn, void *ctx);
+
+// Consome os eventos e avança as máquinas de gestos. Devolve em quantos
+// ms deve ser chamado de novo (timeouts pendentes) ou 0 se não precisar.
+uint32_t buttons_process(void);
+
+bool buttons_is_pressed(uint8_t button);
+uint32_t buttons_dropped(void);
+
+const char *buttons_gesture_name(button_gesture_t g);
+
+#endif
@@ -0,0 +1,51 @@
+#include <string.h>
+#include "flash_sim.h"
+
+static void sim_read(void *ctx, uint32_t off, void *dst, size_t len) {
+    flash_sim_t *sim = (flash_sim_t *)ctx;
+    memcpy(dst, sim->mem + off, len);
+}
+
+static bool sim_program(void *ctx, uint32_t off, const uint8_t *src, size_t len) {
+    flash_sim_t *sim = (flash_sim_t *)ctx;
+    if (off % FLASH_STORE_PAGE_SIZE || len % FLASH_STORE_PAGE_SIZE || off + len > sim->size) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] & ~sim->mem[off + i]) {
+            sim->violations++;
+        }
+        sim->mem[off + i] &= src[i];
+    }
+    sim->programs++;
+    return true;
+}
+
+static bool sim_erase(void *ctx, uint32_t off) {
+    flash_sim_t *sim = (flash_sim_t *)ctx;
+    if (off % FLASH_STORE_SECTOR_SIZE || off + FLASH_STORE_SECTOR_SIZE > sim->size) {
+        return false;
+    }
+    memset(sim->mem + off, 0xFF, FLASH_STORE_SECTOR_SIZE);
+    sim->erases++;
+    uint32_t sector = off / FLASH_STORE_SECTOR_SIZE;
+    if (sector < FLASH_SIM_MAX_SECTORS) {
+        sim->sector_erases[sector]++;
+    }
+    return true;
+}
+
+void flash_sim_init(flash_sim_t *sim, uint8_t *mem, uint32_t size) {
+    memset(sim, 0, sizeof(*sim));
+    sim->mem  = mem;
+    sim->size = size;
+    memset(mem, 0xFF, size);
+}
+
+void flash_sim_dev(flash_sim_t *sim, flash_store_dev_t *dev) {
+    dev->size    = sim->size;
+    dev->ctx     = sim;
+    dev->read    = sim_read;
+    dev->program = sim_program;
+    dev->erase   = sim_erase;
+}
@@ -0,0 +1,24 @@
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+#include "flash_store.h"
+
+// Simulador de flash NOR em RAM para rodar flash_store no host:
+// apagar leva os bytes a 0xFF e gravar só consegue levar bits de 1 a 0.
+
+#define FLASH_SIM_MAX_SECTORS 64
+
+typedef struct {
+    uint8_t  *mem;
+    uint32_t size;
+    uint32_t erases;
+    uint32_t programs;
+    uint32_t violations; // tentativas de levar um bit de 0 a 1 sem apagar
+    uint32_t sector_erases[FLASH_SIM_MAX_SECTORS];
+} flash_sim_t;
+
+void flash_sim_init(flash_sim_t *sim, uint8_t *mem, uint32_t size);
+void flash_sim_dev(flash_sim_t *sim, flash_store_dev_t *dev);
+
+#endif
@@ -0,0 +1,472 @@
+#include <string.h>
+#include <stddef.h>
+#include "flash_store.h"
+
+// Cabeçalho no início de cada setor (16 bytes)
+#define FS_SECTOR_MAGIC 0x534C4442u // "BDLS"
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t crc;
+    uint32_t reserved;
+} fs_sector_hdr_t;
+
+// Cabeçalho de registro (8 bytes); o CRC cobre os 4 primeiros bytes + dados
+typedef struct {
+    uint8_t  type;
+    uint8_t  key;
+    uint16_t len;
+    uint32_t crc;
+} fs_rec_hdr_t;
+
+#define FS_REC_KV   0x4B // 'K'
+#define FS_REC_DEL  0x44 // 'D'
+#define FS_REC_LOG  0x4C // 'L'
+#define FS_REC_FREE 0xFF
+
+#define FS_ALIGN(n) (((n) + 3u) & ~3u)
+#define FS_NO_PAGE  0xFFFFFFFFu
+
+// Espaço reservado no fim de cada setor para realocar todas as chaves
+// durante a coleta de lixo, mesmo que o setor atual esteja quase cheio
+#define FS_KV_RESERVE (FLASH_STORE_MAX_KEYS * FS_ALIGN(sizeof(fs_rec_hdr_t) + FLASH_STORE_MAX_VALUE))
+
+typedef struct {
+    uint8_t  key;
+    uint16_t len;
+    uint32_t addr; // endereço do registro na região
+} fs_key_t;
+
+static const flash_store_dev_t *fs_dev;
+static uint32_t fs_sectors;
+static uint32_t fs_head;      // setor sendo escrito
+static uint32_t fs_head_seq;
+static uint32_t fs_wpos;      // próxima posição livre dentro do setor atual
+
+// Página atual mantida em RAM; só vai para a flash quando enche ou no flush
+static uint8_t  fs_page[FLASH_STORE_PAGE_SIZE];
+static uint32_t fs_page_off = FS_NO_PAGE;
+static bool     fs_page_dirty;
+
+static fs_key_t fs_keys[FLASH_STORE_MAX_KEYS];
+static uint32_t fs_n_keys;
+
+static flash_store_stats_t fs_stats;
+
+uint32_t flash_store_crc32(uint32_t crc, const void *data, size_t len) {
+    // CRC-32 (IEEE) com tabela de 16 entradas para economizar flash
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static uint32_t sector_base(uint32_t sector) {
+    return sector * FLASH_STORE_SECTOR_SIZE;
+}
+
+// Leitura que enxerga também os bytes ainda pendentes na página em RAM
+static void fs_read(uint32_t off, void *dst, size_t len) {
+    fs_dev->read(fs_dev->ctx, off, dst, len);
+    if (fs_page_off == FS_NO_PAGE || off >= fs_page_off + FLASH_STORE_PAGE_SIZE || off + len <= fs_page_off) {
+        return;
+    }
+    uint32_t from = off > fs_page_off ? off : fs_page_off;
+    uint32_t to   = (off + len < fs_page_off + FLASH_STORE_PAGE_SIZE) ? off + len : fs_page_off + FLASH_STORE_PAGE_SIZE;
+    memcpy((uint8_t *)dst + (from - off), fs_page + (from - fs_page_off), to - from);
+}
+
+static bool fs_flush_page(void) {
+    if (!fs_page_dirty) {
+        return true;
+    }
+    fs_page_dirty = false;
+    fs_stats.page_programs++;
+    return fs_dev->program(fs_dev->ctx, fs_page_off, fs_page, FLASH_STORE_PAGE_SIZE);
+}
+
+// Escreve sequencialmente através da página em RAM
+static bool fs_write(uint32_t off, const void *src, size_t len) {
+    const uint8_t *s = (const uint8_t *)src;
+    while (len) {
+        uint32_t base = off & ~(uint32_t)(FLASH_STORE_PAGE_SIZE - 1);
+        if (base != fs_page_off) {
+            if (!fs_flush_page()) {
+                return false;
+            }
+            fs_dev->read(fs_dev->ctx, base, fs_page, FLASH_STORE_PAGE_SIZE);
+            fs_page_off = base;
+        }
+        uint32_t n = base + FLASH_STORE_PAGE_SIZE - off;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(fs_page + (off - base), s, n);
+        fs_page_dirty = true;
+        off += n;
+        s   += n;
+        len -= n;
+        if (off == base + FLASH_STORE_PAGE_SIZE && !fs_flush_page()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool fs_erase(uint32_t sector) {
+    uint32_t base = sector_base(sector);
+    if (fs_page_off != FS_NO_PAGE && fs_page_off >= base && fs_page_off < base + FLASH_STORE_SECTOR_SIZE) {
+        fs_page_off = FS_NO_PAGE;
+        fs_page_dirty = false;
+    }
+    fs_stats.erases++;
+    return fs_dev->erase(fs_dev->ctx, base);
+}
+
+static bool sector_is_blank(uint32_t sector) {
+    uint32_t chunk[16];
+    for (uint32_t off = 0; off < FLASH_STORE_SECTOR_SIZE; off += sizeof(chunk)) {
+        fs_read(sector_base(sector) + off, chunk, sizeof(chunk));
+        for (size_t i = 0; i < sizeof(chunk) / sizeof(chunk[0]); i++) {
+            if (chunk[i] != 0xFFFFFFFFu) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool sector_header_valid(uint32_t sector, fs_sector_hdr_t *hdr) {
+    fs_read(sector_base(sector), hdr, sizeof(*hdr));
+    return hdr->magic == FS_SECTOR_MAGIC &&
+           hdr->crc == flash_store_crc32(0, hdr, offsetof(fs_sector_hdr_t, crc));
+}
+
+static uint32_t rec_crc(const fs_rec_hdr_t *hdr, const void *data) {
+    uint32_t crc = flash_store_crc32(0, hdr, offsetof(fs_rec_hdr_t, crc));
+    return flash_store_crc32(crc, data, hdr->len);
+}
+
+static fs_key_t *find_key(uint8_t key) {
+    for (uint32_t i = 0; i < fs_n_keys; i++) {
+        if (fs_keys[i].key == key) {
+            return &fs_keys[i];
+        }
+    }
+    return NULL;
+}
+
+static void index_set(uint8_t key, uint32_t addr, uint16_t len) {
+    fs_key_t *k = find_key(key);
+    if (!k) {
+        if (fs_n_keys >= FLASH_STORE_MAX_KEYS) {
+            return;
+        }
+        k = &fs_keys[fs_n_keys++];
+        k->key = key;
+    }
+    k->addr = addr;
+    k->len  = len;
+}
+
+static void index_del(uint8_t key) {
+    fs_key_t *k = find_key(key);
+    if (k) {
+        *k = fs_keys[--fs_n_keys];
+    }
+}
+
+static bool open_next_sector(void);
+
+// Anexa um registro ao setor atual. Escritas normais não usam a reserva do
+// fim do setor; as realocações da coleta de lixo podem usá-la.
+static bool write_record(uint8_t type, uint8_t key, const void *data, uint16_t len, bool use_reserve) {
+    uint32_t size  = FS_ALIGN(sizeof(fs_rec_hdr_t) + len);
+    uint32_t limit = FLASH_STORE_SECTOR_SIZE - (use_reserve ? 0 : FS_KV_RESERVE);
+    if (fs_wpos + size > limit) {
+        if (use_reserve || !open_next_sector()) {
+            return false;
+        }
+    }
+
+    fs_rec_hdr_t hdr = { .type = type, .key = key, .len = len };
+    hdr.crc = rec_crc(&hdr, data);
+
+    uint32_t addr = sector_base(fs_head) + fs_wpos;
+    if (!fs_write(addr, &hdr, sizeof(hdr)) || !fs_write(addr + sizeof(hdr), data, len)) {
+        return false;
+    }
+    fs_wpos += size;
+    fs_stats.records++;
+
+    if (type == FS_REC_KV) {
+        index_set(key, addr, len);
+    } else if (type == FS_REC_DEL) {
+        index_del(key);
+    }
+    return true;
+}
+
+static bool write_sector_header(uint32_t sector, uint32_t seq) {
+    fs_sector_hdr_t hdr = { .magic = FS_SECTOR_MAGIC, .seq = seq, .reserved = 0xFFFFFFFFu };
+    hdr.crc = flash_store_crc32(0, &hdr, offsetof(fs_sector_hdr_t, crc));
+    fs_head     = sector;
+    fs_head_seq = seq;
+    return fs_write(sector_base(sector), &hdr, sizeof(hdr));
+}
+
+// Copia para o setor atual as chaves vivas de "sector"
+static bool relocate_keys(uint32_t sector) {
+    uint32_t base = sector_base(sector);
+    uint8_t value[FLASH_STORE_MAX_VALUE];
+    for (uint32_t i = 0; i < fs_n_keys; i++) {
+        fs_key_t k = fs_keys[i];
+        if (k.addr < base || k.addr >= base + FLASH_STORE_SECTOR_SIZE) {
+            continue;
+        }
+        fs_read(k.addr + sizeof(fs_rec_hdr_t), value, k.len);
+        if (!write_record(FS_REC_KV, k.key, value, k.len, true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Copia as chaves vivas de "sector" e o apaga. As cópias vão para a flash
+// antes do apagamento: uma queda entre os dois deixa as chaves em dobro
+// (a montagem fica com a mais nova), nunca sem elas.
+static bool reclaim_sector(uint32_t sector) {
+    return relocate_keys(sector) && fs_flush_page() && fs_erase(sector);
+}
+
+// Avança para o próximo setor do anel. O setor seguinte a ele (o mais
+// antigo) é recuperado logo em seguida, de modo que sempre exista um setor
+// apagado à frente: cada setor é apagado uma vez por volta do anel.
+// Ordem das gravações: chaves copiadas, cabeçalho, apagamento do antigo.
+// Uma queda antes do cabeçalho deixa o setor novo sem cabeçalho (a
+// montagem o ignora e as chaves continuam valendo no antigo).
+static bool open_next_sector(void) {
+    if (!fs_flush_page()) {
+        return false;
+    }
+    uint32_t next   = (fs_head + 1) % fs_sectors;
+    uint32_t victim = (next + 1) % fs_sectors;
+    if (!sector_is_blank(next) && !fs_erase(next)) {
+        return false;
+    }
+    fs_head = next;
+    fs_wpos = sizeof(fs_sector_hdr_t);
+    if (!relocate_keys(victim) || !fs_flush_page()) {
+        return false;
+    }
+    if (!write_sector_header(next, fs_head_seq + 1) || !fs_flush_page()) {
+        return false;
+    }
+    return sector_is_blank(victim) || fs_erase(victim);
+}
+
+// Percorre os registros de um setor. No setor atual todos os CRCs são
+// verificados para achar o fim real do log; nos demais, só os cabeçalhos
+// (e os valores de chave, que são poucos). Devolve a posição livre.
+static uint32_t scan_sector(uint32_t sector, bool is_head) {
+    uint32_t base = sector_base(sector);
+    uint32_t pos  = sizeof(fs_sector_hdr_t);
+    uint8_t data[FLASH_STORE_MAX_RECORD];
+
+    while (pos + sizeof(fs_rec_hdr_t) <= FLASH_STORE_SECTOR_SIZE) {
+        fs_rec_hdr_t hdr;
+        fs_read(base + pos, &hdr, sizeof(hdr));
+        if (hdr.type == FS_REC_FREE) {
+            if (hdr.key == 0xFF && hdr.len == 0xFFFF && hdr.crc == 0xFFFFFFFFu) {
+                return pos;
+            }
+            break;
+        }
+        uint32_t size = FS_ALIGN(sizeof(hdr) + hdr.len);
+        if (hdr.len > FLASH_STORE_MAX_RECORD || pos + size > FLASH_STORE_SECTOR_SIZE) {
+            break;
+        }
+        bool is_kv = (hdr.type == FS_REC_KV || hdr.type == FS_REC_DEL);
+        if (is_head || is_kv) {
+            fs_read(base + pos + sizeof(hdr), data, hdr.len);
+            if (rec_crc(&hdr, data) != hdr.crc) {
+                break;
+            }
+        }
+        if (hdr.type == FS_REC_KV && hdr.len <= FLASH_STORE_MAX_VALUE) {
+            index_set(hdr.key, base + pos, hdr.len);
+        } else if (hdr.type == FS_REC_DEL) {
+            index_del(hdr.key);
+        }
+        fs_stats.records++;
+        pos += size;
+    }
+    // Registro corrompido (ex.: queda de energia durante a escrita):
+    // o setor é dado como cheio e a próxima escrita abre outro.
+    return FLASH_STORE_SECTOR_SIZE;
+}
+
+// Falha ao montar ou formatar: a região fica inacessível (get/set/append
+// falham) até uma nova montagem, em vez de gravar com head/wpos inválidos
+static bool fs_unmount(void) {
+    fs_dev    = NULL;
+    fs_n_keys = 0;
+    return false;
+}
+
+bool flash_store_format(void) {
+    if (!fs_dev) {
+        return false;
+    }
+    for (uint32_t s = 0; s < fs_sectors; s++) {
+        if (!sector_is_blank(s) && !fs_erase(s)) {
+            return fs_unmount();
+        }
+    }
+    fs_n_keys = 0;
+    fs_wpos   = sizeof(fs_sector_hdr_t);
+    return (write_sector_header(0, 1) && fs_flush_page()) || fs_unmount();
+}
+
+bool flash_store_mount(const flash_store_dev_t *dev) {
+    fs_dev        = dev;
+    fs_sectors    = dev->size / FLASH_STORE_SECTOR_SIZE;
+    fs_page_off   = FS_NO_PAGE;
+    fs_page_dirty = false;
+    fs_n_keys     = 0;
+    memset(&fs_stats, 0, sizeof(fs_stats));
+    if (fs_sectors < 3) {
+        return fs_unmount();
+    }
+
+    // 1) Localiza o setor mais recente só pelos cabeçalhos de setor
+    bool found = false;
+    for (uint32_t s = 0; s < fs_sectors; s++) {
+        fs_sector_hdr_t hdr;
+        if (sector_header_valid(s, &hdr) && (!found || (int32_t)(hdr.seq - fs_head_seq) > 0)) {
+            fs_head     = s;
+            fs_head_seq = hdr.seq;
+            found       = true;
+        }
+    }
+    if (!found) {
+        return flash_store_format();
+    }
+
+    // 2) Reconstrói o índice do mais antigo para o mais novo
+    for (uint32_t i = 1; i <= fs_sectors; i++) {
+        uint32_t s = (fs_head + i) % fs_sectors;
+        fs_sector_hdr_t hdr;
+        if (!sector_header_valid(s, &hdr)) {
+            continue;
+        }
+        uint32_t end = scan_sector(s, s == fs_head);
+        if (s == fs_head) {
+            fs_wpos = end;
+        }
+    }
+
+    // 3) Conclui uma coleta de lixo interrompida por queda de energia
+    uint32_t spare = (fs_head + 1) % fs_sectors;
+    if (!sector_is_blank(spare) && !reclaim_sector(spare)) {
+        return fs_unmount();
+    }
+    return fs_flush_page() || fs_unmount();
+}
+
+bool flash_store_set(uint8_t key, const void *val, uint16_t len) {
+    if (!fs_dev || len > FLASH_STORE_MAX_VALUE) {
+        return false;
+    }
+    if (!find_key(key) && fs_n_keys >= FLASH_STORE_MAX_KEYS) {
+        return false;
+    }
+    // Evita gastar flash regravando um valor idêntico
+    fs_key_t *k = find_key(key);
+    if (k && k->len == len) {
+        uint8_t cur[FLASH_STORE_MAX_VALUE];
+        fs_read(k->addr + sizeof(fs_rec_hdr_t), cur, len);
+        if (memcmp(cur, val, len) == 0) {
+            return true;
+        }
+    }
+    // Configurações são raras: vão para a flash na hora
+    return write_record(FS_REC_KV, key, val, len, false) && fs_flush_page();
+}
+
+int flash_store_get(uint8_t key, void *buf, uint16_t cap) {
+    fs_key_t *k = fs_dev ? find_key(key) : NULL;
+    if (!k) {
+        return -1;
+    }
+    uint16_t n = k->len < cap ? k->len : cap;
+    fs_read(k->addr + sizeof(fs_rec_hdr_t), buf, n);
+    return k->len;
+}
+
+bool flash_store_del(uint8_t key) {
+    if (!fs_dev || !find_key(key)) {
+        return true;
+    }
+    return write_record(FS_REC_DEL, key, NULL, 0, false) && fs_flush_page();
+}
+
+bool flash_store_append(uint8_t stream, const void *data, uint16_t len) {
+    if (!fs_dev || len > FLASH_STORE_MAX_RECORD) {
+        return false;
+    }
+    return write_record(FS_REC_LOG, stream, data, len, false);
+}
+
+void flash_store_log_replay(uint8_t stream, flash_store_log_cb_t cb, void *ctx) {
+    if (!fs_dev) {
+        return;
+    }
+    uint8_t data[FLASH_STORE_MAX_RECORD];
+    for (uint32_t i = 1; i <= fs_sectors; i++) {
+        uint32_t s = (fs_head + i) % fs_sectors;
+        fs_sector_hdr_t shdr;
+        if (!sector_header_valid(s, &shdr)) {
+            continue;
+        }
+        uint32_t base = sector_base(s);
+        uint32_t end  = (s == fs_head) ? fs_wpos : FLASH_STORE_SECTOR_SIZE;
+        uint32_t pos  = sizeof(fs_sector_hdr_t);
+        while (pos + sizeof(fs_rec_hdr_t) <= end) {
+            fs_rec_hdr_t hdr;
+            fs_read(base + pos, &hdr, sizeof(hdr));
+            uint32_t size = FS_ALIGN(sizeof(hdr) + hdr.len);
+            if (hdr.type == FS_REC_FREE || hdr.len > FLASH_STORE_MAX_RECORD || pos + size > end) {
+                break;
+            }
+            if (hdr.type == FS_REC_LOG && hdr.key == stream) {
+                fs_read(base + pos + sizeof(hdr), data, hdr.len);
+                if (rec_crc(&hdr, data) == hdr.crc && !cb(data, hdr.len, ctx)) {
+                    return;
+                }
+            }
+            pos += size;
+        }
+    }
+}
+
+bool flash_store_flush(void) {
+    return fs_dev ? fs_flush_page() : false;
+}
+
+void flash_store_get_stats(flash_store_stats_t *out) {
+    *out = fs_stats;
+    out->sectors    = fs_sectors;
+    out->head_sector = fs_head;
+    out->head_seq   = fs_head_seq;
+    out->used_bytes = fs_wpos;
+    out->keys       = fs_n_keys;
+}
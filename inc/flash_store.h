@@ -0,0 +1,85 @@
+#ifndef FLASH_STORE_H
+#define FLASH_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =====================
+//  ARMAZENAMENTO EM FLASH
+// =====================
+// Armazenamento log-structured numa região reservada da flash:
+//   - setores usados em anel (rotação = nivelamento de desgaste)
+//   - cada setor começa com um cabeçalho contendo um número de sequência
+//   - registros com CRC32: chave/valor (o último vence) ou log (append)
+//   - escrita acumulada em RAM e gravada uma página de cada vez
+// O acesso ao hardware passa por flash_store_dev_t, permitindo rodar o
+// mesmo código no RP2040 ou no host contra um simulador em RAM.
+
+#define FLASH_STORE_SECTOR_SIZE 4096
+#define FLASH_STORE_PAGE_SIZE   256
+#define FLASH_STORE_MAX_KEYS    8
+#define FLASH_STORE_MAX_VALUE   64   // maior valor chave/valor
+#define FLASH_STORE_MAX_RECORD  256  // maior registro de log
+
+// Chaves de configuração
+enum {
+    FS_KEY_WIFI_SSID = 1,
+    FS_KEY_WIFI_PASS,
+    FS_KEY_LED_STATE,
+    FS_KEY_WIFI_CACHE,   // BSSID/canal/lease da última conexão
+    FS_KEY_WIFI_STATIC,  // IP fixo (wifi_ip_config_t)
+};
+
+// Fluxos de log
+enum {
+    FS_LOG_HISTORY = 1,
+};
+
+typedef struct {
+    uint32_t size; // tamanho da região (múltiplo do setor)
+    void *ctx;
+    // Leitura livre; "program" recebe páginas inteiras e alinhadas;
+    // "erase" recebe o deslocamento de um setor.
+    void (*read)(void *ctx, uint32_t off, void *dst, size_t len);
+    bool (*program)(void *ctx, uint32_t off, const uint8_t *src, size_t len);
+    bool (*erase)(void *ctx, uint32_t off);
+} flash_store_dev_t;
+
+typedef struct {
+    uint32_t sectors;
+    uint32_t head_sector;
+    uint32_t head_seq;
+    uint32_t used_bytes;    // bytes ocupados no setor atual
+    uint32_t records;       // registros válidos encontrados/gravados
+    uint32_t erases;
+    uint32_t page_programs;
+    uint32_t keys;
+} flash_store_stats_t;
+
+// Monta a região: localiza o setor mais recente pelos cabeçalhos e
+// reconstrói o índice de chaves. Formata se não houver dados válidos.
+bool flash_store_mount(const flash_store_dev_t *dev);
+bool flash_store_format(void);
+
+// Chave/valor: gravados imediatamente (set/del fazem flush)
+bool flash_store_set(uint8_t key, const void *val, uint16_t len);
+int  flash_store_get(uint8_t key, void *buf, uint16_t cap); // -1 se ausente
+bool flash_store_del(uint8_t key);
+
+// Log: acumulado em RAM até completar uma página ou até flash_store_flush()
+bool flash_store_append(uint8_t stream, const void *data, uint16_t len);
+
+// Percorre os registros de um fluxo do mais antigo ao mais novo;
+// o callback devolve false para interromper.
+typedef bool (*flash_store_log_cb_t)(const void *data, uint16_t len, void *ctx);
+void flash_store_log_replay(uint8_t stream, flash_store_log_cb_t cb, void *ctx);
+
+// Grava a página pendente (se houver)
+bool flash_store_flush(void);
+
+void flash_store_get_stats(flash_store_stats_t *out);
+
+uint32_t flash_store_crc32(uint32_t crc, const void *data, size_t len);
+
+#endif
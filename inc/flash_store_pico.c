@@ -0,0 +1,63 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/regs/addressmap.h"
+#include "flash_store_pico.h"
+
+typedef struct {
+    uint32_t off;
+    const uint8_t *src;
+    size_t len;
+} flash_op_t;
+
+static uint32_t stall_us;
+
+// Leitura direto pelo XIP, sem parar a execução
+static void pico_read(void *ctx, uint32_t off, void *dst, size_t len) {
+    memcpy(dst, (const void *)(XIP_BASE + FLASH_STORE_REGION_OFFSET + off), len);
+}
+
+// Executadas com interrupções desligadas e o outro núcleo em espera
+static void do_program(void *param) {
+    flash_op_t *op = (flash_op_t *)param;
+    flash_range_program(FLASH_STORE_REGION_OFFSET + op->off, op->src, op->len);
+}
+
+static void do_erase(void *param) {
+    flash_op_t *op = (flash_op_t *)param;
+    flash_range_erase(FLASH_STORE_REGION_OFFSET + op->off, FLASH_SECTOR_SIZE);
+}
+
+static bool run_safe(void (*fn)(void *), flash_op_t *op) {
+    uint32_t start = time_us_32();
+    int rc = flash_safe_execute(fn, op, UINT32_MAX);
+    stall_us += time_us_32() - start;
+    return rc == PICO_OK;
+}
+
+static bool pico_program(void *ctx, uint32_t off, const uint8_t *src, size_t len) {
+    flash_op_t op = { .off = off, .src = src, .len = len };
+    return run_safe(do_program, &op);
+}
+
+static bool pico_erase(void *ctx, uint32_t off) {
+    flash_op_t op = { .off = off };
+    return run_safe(do_erase, &op);
+}
+
+static const flash_store_dev_t pico_dev = {
+    .size    = FLASH_STORE_REGION_SIZE,
+    .ctx     = NULL,
+    .read    = pico_read,
+    .program = pico_program,
+    .erase   = pico_erase,
+};
+
+const flash_store_dev_t *flash_store_pico_dev(void) {
+    return &pico_dev;
+}
+
+uint32_t flash_store_pico_stall_us(void) {
+    return stall_us;
+}
@@ -0,0 +1,17 @@
+#ifndef FLASH_STORE_PICO_H
+#define FLASH_STORE_PICO_H
+
+#include "flash_store.h"
+
+// Região reservada no fim da flash do RP2040 (fora da área do programa)
+#define FLASH_STORE_REGION_SIZE   (32 * FLASH_STORE_SECTOR_SIZE)
+#define FLASH_STORE_REGION_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_STORE_REGION_SIZE)
+
+// Gravações usam flash_safe_execute(): só depois de pres_start(), com o
+// núcleo 1 pronto para ser pausado
+const flash_store_dev_t *flash_store_pico_dev(void);
+
+// Tempo total (us) com o XIP parado em gravações/apagamentos
+uint32_t flash_store_pico_stall_us(void);
+
+#endif
@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "history.h"
+
+// Buffers circulares pré-alocados (nenhuma alocação dinâmica)
+static history_sample_t raw_buf[HISTORY_RAW_LEN];
+static history_rollup_t min_buf[HISTORY_MIN_LEN];
+static history_rollup_t hour_buf[HISTORY_HOUR_LEN];
+
+// Total de entradas já gravadas em cada resolução (nunca volta a zero)
+static uint32_t totals[HISTORY_RES_COUNT];
+
+static const uint32_t ring_len[HISTORY_RES_COUNT] = {
+    HISTORY_RAW_LEN, HISTORY_MIN_LEN, HISTORY_HOUR_LEN
+};
+
+// Acumulador de um intervalo de agregação ainda aberto
+typedef struct {
+    uint32_t bucket;
+    int32_t  temp_sum, umi_sum;
+    int16_t  temp_min, temp_max;
+    int16_t  umi_min,  umi_max;
+    uint16_t n;
+} history_acc_t;
+
+static history_acc_t acc_min;
+static history_acc_t acc_hour;
+
+static void (*rollup_hook)(const history_rollup_t *r);
+
+static int16_t to_centi(float v) {
+    float c = roundf(v * 100.0f);
+    if (c > INT16_MAX) return INT16_MAX;
+    if (c < INT16_MIN) return INT16_MIN;
+    return (int16_t)c;
+}
+
+static uint32_t oldest_seq(history_res_t res) {
+    return totals[res] > ring_len[res] ? totals[res] - ring_len[res] : 0;
+}
+
+static void push_rollup(history_res_t res, const history_rollup_t *r) {
+    history_rollup_t *buf = (res == HISTORY_RES_MIN) ? min_buf : hour_buf;
+    buf[totals[res] % ring_len[res]] = *r;
+    totals[res]++;
+}
+
+// Fecha o intervalo acumulado e grava o agregado na resolução indicada
+static void acc_flush(history_acc_t *acc, history_res_t res, uint32_t period_s) {
+    if (acc->n == 0) {
+        return;
+    }
+    history_rollup_t r = {
+        .t        = acc->bucket * period_s,
+        .temp_min = acc->temp_min,
+        .temp_avg = (int16_t)(acc->temp_sum / acc->n),
+        .temp_max = acc->temp_max,
+        .umi_min  = acc->umi_min,
+        .umi_avg  = (int16_t)(acc->umi_sum / acc->n),
+        .umi_max  = acc->umi_max,
+    };
+    push_rollup(res, &r);
+    acc->n = 0;
+    if (res == HISTORY_RES_MIN && rollup_hook) {
+        rollup_hook(&r);
+    }
+}
+
+// Soma ao intervalo aberto um agregado (uma amostra bruta tem min = média = max)
+// com o peso das "weight" amostras que ele representa
+static void acc_add(history_acc_t *acc, history_res_t res, uint32_t period_s, const history_rollup_t *s,
+                    uint16_t weight) {
+    uint32_t bucket = s->t / period_s;
+    if (acc->n && bucket != acc->bucket) {
+        acc_flush(acc, res, period_s);
+    }
+    if (acc->n == 0) {
+        acc->bucket   = bucket;
+        acc->temp_sum = 0;
+        acc->umi_sum  = 0;
+        acc->temp_min = s->temp_min;
+        acc->temp_max = s->temp_max;
+        acc->umi_min  = s->umi_min;
+        acc->umi_max  = s->umi_max;
+    }
+    acc->temp_sum += (int32_t)s->temp_avg * weight;
+    acc->umi_sum  += (int32_t)s->umi_avg * weight;
+    if (s->temp_min < acc->temp_min) acc->temp_min = s->temp_min;
+    if (s->temp_max > acc->temp_max) acc->temp_max = s->temp_max;
+    if (s->umi_min  < acc->umi_min)  acc->umi_min  = s->umi_min;
+    if (s->umi_max  > acc->umi_max)  acc->umi_max  = s->umi_max;
+    acc->n += weight;
+}
+
+void history_init(void) {
+    memset(totals, 0, sizeof(totals));
+    memset(&acc_min, 0, sizeof(acc_min));
+    memset(&acc_hour, 0, sizeof(acc_hour));
+}
+
+void history_add(uint32_t t_s, float temp, float umi) {
+    history_sample_t s = {
+        .t    = t_s,
+        .temp = to_centi(temp),
+        .umi  = to_centi(umi),
+    };
+    raw_buf[totals[HISTORY_RES_RAW] % HISTORY_RAW_LEN] = s;
+    totals[HISTORY_RES_RAW]++;
+
+    history_rollup_t r = {
+        .t = s.t,
+        .temp_min = s.temp, .temp_avg = s.temp, .temp_max = s.temp,
+        .umi_min  = s.umi,  .umi_avg  = s.umi,  .umi_max  = s.umi,
+    };
+    acc_add(&acc_min,  HISTORY_RES_MIN,  60,   &r, 1);
+    acc_add(&acc_hour, HISTORY_RES_HOUR, 3600, &r, 1);
+}
+
+void history_set_rollup_hook(void (*hook)(const history_rollup_t *r)) {
+    rollup_hook = hook;
+}
+
+void history_restore(const history_rollup_t *r) {
+    push_rollup(HISTORY_RES_MIN, r);
+    acc_add(&acc_hour, HISTORY_RES_HOUR, 3600, r, 60 / HISTORY_SAMPLE_S);
+}
+
+bool history_parse_res(const char *s, history_res_t *out) {
+    if (!s || !*s || strcmp(s, "raw") == 0) {
+        *out = HISTORY_RES_RAW;
+    } else if (strcmp(s, "1m") == 0) {
+        *out = HISTORY_RES_MIN;
+    } else if (strcmp(s, "1h") == 0) {
+        *out = HISTORY_RES_HOUR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+uint32_t history_count(history_res_t res) {
+    return totals[res] - oldest_seq(res);
+}
+
+static bool history_get(history_res_t res, uint32_t seq, history_rollup_t *out) {
+    if (seq < oldest_seq(res) || seq >= totals[res]) {
+        return false;
+    }
+    uint32_t idx = seq % ring_len[res];
+    if (res == HISTORY_RES_RAW) {
+        const history_sample_t *s = &raw_buf[idx];
+        out->t = s->t;
+        out->temp_min = out->temp_avg = out->temp_max = s->temp;
+        out->umi_min  = out->umi_avg  = out->umi_max  = s->umi;
+    } else {
+        *out = (res == HISTORY_RES_MIN) ? min_buf[idx] : hour_buf[idx];
+    }
+    return true;
+}
+
+static uint32_t entry_time(history_res_t res, uint32_t seq) {
+    uint32_t idx = seq % ring_len[res];
+    switch (res) {
+        case HISTORY_RES_RAW: return raw_buf[idx].t;
+        case HISTORY_RES_MIN: return min_buf[idx].t;
+        default:              return hour_buf[idx].t;
+    }
+}
+
+void history_cursor_init(history_cursor_t *c, history_res_t res, uint32_t from_s) {
+    // Busca binária: os tempos são monotônicos dentro do buffer
+    uint32_t lo = oldest_seq(res);
+    uint32_t hi = totals[res];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (entry_time(res, mid) < from_s) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    c->res = res;
+    c->seq = lo;
+}
+
+bool history_next(history_cursor_t *c, history_rollup_t *out) {
+    // Se o buffer deu a volta durante a leitura, pula para a mais antiga
+    uint32_t oldest = oldest_seq(c->res);
+    if (c->seq < oldest) {
+        c->seq = oldest;
+    }
+    if (!history_get(c->res, c->seq, out)) {
+        return false;
+    }
+    c->seq++;
+    return true;
+}
+
+// Escreve um valor em centésimos como decimal ("-12.05")
+static int format_centi(char *buf, size_t cap, int16_t v) {
+    int32_t a = v < 0 ? -(int32_t)v : v;
+    return snprintf(buf, cap, "%s%ld.%02ld", v < 0 ? "-" : "", (long)(a / 100), (long)(a % 100));
+}
+
+const char *history_csv_header(history_res_t res) {
+    if (res == HISTORY_RES_RAW) {
+        return "t,temperatura,umidade\n";
+    }
+    return "t,temp_min,temp_avg,temp_max,umi_min,umi_avg,umi_max\n";
+}
+
+size_t history_format_csv(history_res_t res, const history_rollup_t *r, char *buf, size_t cap) {
+    const int16_t raw_vals[] = { r->temp_avg, r->umi_avg };
+    const int16_t agg_vals[] = {
+        r->temp_min, r->temp_avg, r->temp_max,
+        r->umi_min,  r->umi_avg,  r->umi_max
+    };
+    const int16_t *vals = (res == HISTORY_RES_RAW) ? raw_vals : agg_vals;
+    int n_vals = (res == HISTORY_RES_RAW) ? 2 : 6;
+
+    int pos = snprintf(buf, cap, "%lu", (unsigned long)r->t);
+    for (int i = 0; i < n_vals && pos >= 0 && (size_t)pos < cap; i++) {
+        buf[pos++] = ',';
+        pos += format_centi(buf + pos, cap - pos, vals[i]);
+    }
+    if (pos < 0 || (size_t)pos + 1 >= cap) {
+        return 0;
+    }
+    buf[pos++] = '\n';
+    return (size_t)pos;
+}
+
+static uint8_t *put_le32(uint8_t *p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+    return p + 4;
+}
+
+static uint8_t *put_le16(uint8_t *p, int16_t v) {
+    p[0] = (uint16_t)v; p[1] = (uint16_t)v >> 8;
+    return p + 2;
+}
+
+// Formato binário little-endian: brutas = t:u32 temp:i16 umi:i16 (8 bytes);
+// agregados = t:u32 + 6 x i16 na mesma ordem do CSV (16 bytes)
+size_t history_format_bin(history_res_t res, const history_rollup_t *r, uint8_t *buf, size_t cap) {
+    size_t need = (res == HISTORY_RES_RAW) ? sizeof(history_sample_t) : sizeof(history_rollup_t);
+    if (cap < need) {
+        return 0;
+    }
+    uint8_t *p = put_le32(buf, r->t);
+    if (res == HISTORY_RES_RAW) {
+        p = put_le16(p, r->temp_avg);
+        p = put_le16(p, r->umi_avg);
+    } else {
+        p = put_le16(p, r->temp_min);
+        p = put_le16(p, r->temp_avg);
+        p = put_le16(p, r->temp_max);
+        p = put_le16(p, r->umi_min);
+        p = put_le16(p, r->umi_avg);
+        p = put_le16(p, r->umi_max);
+    }
+    return (size_t)(p - buf);
+}
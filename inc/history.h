@@ -0,0 +1,75 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =====================
+//  HISTÓRICO DE SENSORES
+// =====================
+// Série temporal em RAM, pré-alocada, com três resoluções:
+//   - bruta: cada amostra recebida do fetch remoto
+//   - 1 minuto e 1 hora: min/max/média calculados incrementalmente
+// Os valores são guardados em ponto fixo (centésimos de °C e de %).
+
+#define HISTORY_RAW_LEN   720   // 1 hora de amostras a cada 5 s
+#define HISTORY_MIN_LEN   1440  // 24 horas de agregados de 1 minuto
+#define HISTORY_HOUR_LEN  48    // 48 horas de agregados de 1 hora
+#define HISTORY_SAMPLE_S  5     // intervalo nominal entre amostras brutas
+
+typedef enum {
+    HISTORY_RES_RAW = 0,
+    HISTORY_RES_MIN,
+    HISTORY_RES_HOUR,
+    HISTORY_RES_COUNT
+} history_res_t;
+
+// Amostra bruta (8 bytes): segundos desde o boot + valores em centésimos
+typedef struct {
+    uint32_t t;
+    int16_t  temp;
+    int16_t  umi;
+} history_sample_t;
+
+// Agregado (16 bytes): início do intervalo + min/média/max em centésimos
+typedef struct {
+    uint32_t t;
+    int16_t  temp_min, temp_avg, temp_max;
+    int16_t  umi_min,  umi_avg,  umi_max;
+} history_rollup_t;
+
+// Cursor de leitura; "seq" é o número de sequência absoluto da próxima
+// entrada, de modo que novas amostras não invalidam uma leitura em curso.
+typedef struct {
+    history_res_t res;
+    uint32_t      seq;
+} history_cursor_t;
+
+void history_init(void);
+void history_add(uint32_t t_s, float temp, float umi);
+
+// Chamado a cada agregado de 1 minuto fechado (ex.: para persistir)
+void history_set_rollup_hook(void (*hook)(const history_rollup_t *r));
+
+// Reinsere um agregado de 1 minuto salvo (também recompõe a série de 1 h,
+// contando o minuto como 60 / HISTORY_SAMPLE_S amostras)
+void history_restore(const history_rollup_t *r);
+
+// Converte "raw", "1m" ou "1h" na resolução correspondente
+bool history_parse_res(const char *s, history_res_t *out);
+
+uint32_t history_count(history_res_t res);
+
+// Posiciona o cursor na primeira entrada com t >= from_s
+void history_cursor_init(history_cursor_t *c, history_res_t res, uint32_t from_s);
+
+// Lê a próxima entrada (amostras brutas vêm com min = média = max)
+bool history_next(history_cursor_t *c, history_rollup_t *out);
+
+// Serializa uma entrada; devolvem 0 se não couber em "cap"
+size_t history_format_csv(history_res_t res, const history_rollup_t *r, char *buf, size_t cap);
+size_t history_format_bin(history_res_t res, const history_rollup_t *r, uint8_t *buf, size_t cap);
+const char *history_csv_header(history_res_t res);
+
+#endif
@@ -0,0 +1,40 @@
+#include <string.h>
+#include "ipc.h"
+
+void spsc_init(spsc_queue_t *q, void *storage, uint32_t elem_size, uint32_t len) {
+    q->buf        = (uint8_t *)storage;
+    q->elem_size  = elem_size;
+    q->len        = len;
+    q->head       = 0;
+    q->tail       = 0;
+    q->dropped    = 0;
+    q->high_water = 0;
+}
+
+bool spsc_push(spsc_queue_t *q, const void *elem) {
+    uint32_t head = q->head;
+    uint32_t used = head - q->tail;
+    if (used >= q->len) {
+        q->dropped++;
+        return false;
+    }
+    memcpy(q->buf + (head & (q->len - 1)) * q->elem_size, elem, q->elem_size);
+    __mem_fence_release();
+    q->head = head + 1;
+    if (used + 1 > q->high_water) {
+        q->high_water = used + 1;
+    }
+    return true;
+}
+
+bool spsc_pop(spsc_queue_t *q, void *elem) {
+    uint32_t tail = q->tail;
+    if (tail == q->head) {
+        return false;
+    }
+    __mem_fence_acquire();
+    memcpy(elem, q->buf + (tail & (q->len - 1)) * q->elem_size, q->elem_size);
+    __mem_fence_release();
+    q->tail = tail + 1;
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// =====================
+//  COMUNICAÇÃO ENTRE NÚCLEOS
+// =====================
+// Fila SPSC sem lock (um produtor e um consumidor, podem estar em núcleos
+// diferentes) e seqlock para instantâneos de estado com um único escritor.
+// O RP2040 não tem cache; as barreiras (DMB) garantem a ordem das escritas.
+
+typedef struct {
+    uint8_t  *buf;
+    uint32_t elem_size;
+    uint32_t len;               // potência de 2
+    volatile uint32_t head;     // escrito só pelo produtor
+    volatile uint32_t tail;     // escrito só pelo consumidor
+    volatile uint32_t dropped;  // pushes recusados por fila cheia
+    volatile uint32_t high_water;
+} spsc_queue_t;
+
+void spsc_init(spsc_queue_t *q, void *storage, uint32_t elem_size, uint32_t len);
+bool spsc_push(spsc_queue_t *q, const void *elem);
+bool spsc_pop(spsc_queue_t *q, void *elem);
+
+static inline bool spsc_empty(const spsc_queue_t *q) {
+    return q->head == q->tail;
+}
+
+typedef struct {
+    volatile uint32_t seq; // ímpar = escrita em andamento
+} seqlock_t;
+
+static inline void seqlock_write_begin(seqlock_t *l) {
+    l->seq++;
+    __mem_fence_release();
+}
+
+static inline void seqlock_write_end(seqlock_t *l) {
+    __mem_fence_release();
+    l->seq++;
+}
+
+static inline uint32_t seqlock_read_begin(const seqlock_t *l) {
+    uint32_t s;
+    while ((s = l->seq) & 1u) {
+        tight_loop_contents();
+    }
+    __mem_fence_acquire();
+    return s;
+}
+
+// true se houve escrita durante a leitura (é preciso ler de novo)
+static inline bool seqlock_read_retry(const seqlock_t *l, uint32_t start) {
+    __mem_fence_acquire();
+    return l->seq != start;
+}
+
+#endif
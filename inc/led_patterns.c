@@ -0,0 +1,78 @@
+#include <string.h>
+#include "led_patterns.h"
+
+static const led_pattern_t patterns[] = {
+    { "apagado", {   0,   0,   0 }, { 0x00, 0x00, 0x00, 0x00, 0x00 } },
+    { "padrao",  {   0, 255,   0 }, { 0x04, 0x15, 0x13, 0x0A, 0x04 } }, // o antigo /led/on
+    { "cheio",   { 255, 255, 255 }, { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F } },
+    { "borda",   {   0,   0, 255 }, { 0x1F, 0x11, 0x11, 0x11, 0x1F } },
+    { "x",       { 255,   0,   0 }, { 0x11, 0x0A, 0x04, 0x0A, 0x11 } },
+    { "coracao", { 255,   0,  32 }, { 0x0A, 0x1F, 0x1F, 0x0E, 0x04 } },
+    { "seta",    { 255, 160,   0 }, { 0x04, 0x0E, 0x15, 0x04, 0x04 } },
+};
+
+unsigned led_matrix_index(unsigned x, unsigned y) {
+    // O LED 0 fica no canto inferior direito e a fita sobe em zigue-zague:
+    // contando do fim, as linhas pares vão da esquerda para a direita
+    unsigned col = (y % 2 == 0) ? x : LED_MATRIX_W - 1 - x;
+    return LED_MATRIX_W * LED_MATRIX_H - 1 - (y * LED_MATRIX_W + col);
+}
+
+const led_pattern_t *led_pattern_find(const char *name) {
+    for (unsigned i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        if (strcmp(patterns[i].name, name) == 0) {
+            return &patterns[i];
+        }
+    }
+    return NULL;
+}
+
+const led_pattern_t *led_pattern_get(unsigned i) {
+    return i < sizeof(patterns) / sizeof(patterns[0]) ? &patterns[i] : NULL;
+}
+
+void led_pattern_render(const led_pattern_t *p, uint8_t rgb[][3], unsigned count) {
+    memset(rgb, 0, count * 3);
+    for (unsigned y = 0; y < LED_MATRIX_H; y++) {
+        for (unsigned x = 0; x < LED_MATRIX_W; x++) {
+            unsigned i = led_matrix_index(x, y);
+            if ((p->rows[y] & (0x10 >> x)) && i < count) {
+                memcpy(rgb[i], p->rgb, 3);
+            }
+        }
+    }
+}
+
+static int hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static int hex_byte(const char *s) {
+    int hi = hex_nibble(s[0]);
+    int lo = hex_nibble(s[1]);
+    return (hi < 0 || lo < 0) ? -1 : (hi << 4) | lo;
+}
+
+int led_hex_apply(const char *hex, size_t len, uint8_t rgb[][3], unsigned count) {
+    if (len % 8 != 0) {
+        return -1;
+    }
+    // Valida tudo antes de escrever: um quadro inválido não sai pela metade
+    for (size_t k = 0; k < len; k += 8) {
+        int idx = hex_byte(hex + k);
+        if (idx < 0 || (unsigned)idx >= count ||
+            hex_byte(hex + k + 2) < 0 || hex_byte(hex + k + 4) < 0 || hex_byte(hex + k + 6) < 0) {
+            return -1;
+        }
+    }
+    for (size_t k = 0; k < len; k += 8) {
+        uint8_t *px = rgb[hex_byte(hex + k)];
+        px[0] = (uint8_t)hex_byte(hex + k + 2);
+        px[1] = (uint8_t)hex_byte(hex + k + 4);
+        px[2] = (uint8_t)hex_byte(hex + k + 6);
+    }
+    return (int)(len / 8);
+}
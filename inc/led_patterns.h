@@ -0,0 +1,38 @@
+#ifndef LED_PATTERNS_H
+#define LED_PATTERNS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =====================
+//  PADRÕES DA MATRIZ 5x5
+// =====================
+// Tabela constante de desenhos nomeados e montagem de quadros a partir de
+// um texto hexadecimal compacto. Nada aqui toca o hardware: o quadro é
+// montado num buffer RGB e entregue de uma vez ao núcleo 1.
+
+#define LED_MATRIX_W 5
+#define LED_MATRIX_H 5
+
+typedef struct {
+    const char *name;
+    uint8_t     rgb[3];
+    uint8_t     rows[LED_MATRIX_H]; // linha 0 = topo; bit 4 = coluna da esquerda
+} led_pattern_t;
+
+// Índice na fita do LED na coluna x, linha y (fiação em zigue-zague)
+unsigned led_matrix_index(unsigned x, unsigned y);
+
+const led_pattern_t *led_pattern_find(const char *name);
+const led_pattern_t *led_pattern_get(unsigned i); // NULL após o último
+
+// Escreve o desenho em rgb[] (LEDs fora do desenho ficam apagados)
+void led_pattern_render(const led_pattern_t *p, uint8_t rgb[][3], unsigned count);
+
+// Aplica entradas "IIRRGGBB" (índice + cor, em hexadecimal) sobre rgb[].
+// Devolve quantos LEDs foram alterados ou -1 se o texto for inválido;
+// nesse caso rgb[] não é modificado.
+int led_hex_apply(const char *hex, size_t len, uint8_t rgb[][3], unsigned count);
+
+#endif
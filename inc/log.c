@@ -0,0 +1,219 @@
+#include <string.h>
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "log.h"
+
+// Formatos: %d %u %x (32 bits), %f (float com 2 casas) e %i (IPv4 em
+// ordem de rede), um por argumento
+static const struct {
+    uint8_t     level;
+    const char *fmt;
+} catalog[LOG_ID_COUNT] = {
+    [LOG_BOOT]                 = { LOG_INFO,  "boot %u (watchdog=%u)" },
+    [LOG_FLASH_MOUNT_FAIL]     = { LOG_ERROR, "falha ao montar a flash de dados" },
+    [LOG_HTTP_LISTENING]       = { LOG_INFO,  "servidor HTTP na porta %u" },
+    [LOG_HTTP_PCB_FAIL]        = { LOG_ERROR, "http: erro ao criar PCB" },
+    [LOG_HTTP_BIND_FAIL]       = { LOG_ERROR, "http: erro ao ligar na porta %u" },
+    [LOG_FETCH_AUTO]           = { LOG_DEBUG, "fetch: automatico" },
+    [LOG_FETCH_UPDATE]         = { LOG_INFO,  "fetch: via /update" },
+    [LOG_FETCH_BUTTON]         = { LOG_INFO,  "fetch: via botao" },
+    [LOG_FETCH_BUSY]           = { LOG_DEBUG, "fetch: ja em andamento" },
+    [LOG_FETCH_NO_SLOT]        = { LOG_WARN,  "fetch: sem contexto livre" },
+    [LOG_FETCH_PCB_FAIL]       = { LOG_ERROR, "fetch: erro ao criar pcb" },
+    [LOG_FETCH_CONNECT_FAIL]   = { LOG_ERROR, "fetch: tcp_connect err=%d" },
+    [LOG_FETCH_CONNECTED_FAIL] = { LOG_WARN,  "fetch: conexao falhou err=%d" },
+    [LOG_FETCH_SEND_FAIL]      = { LOG_ERROR, "fetch: erro ao enviar GET err=%d" },
+    [LOG_FETCH_OK]             = { LOG_INFO,  "fetch: temp=%f umid=%f" },
+    [LOG_FETCH_PARSE_FAIL]     = { LOG_WARN,  "fetch: falha no parse do JSON" },
+    [LOG_FETCH_NO_JSON]        = { LOG_WARN,  "fetch: resposta sem '{'" },
+    [LOG_FETCH_ERR]            = { LOG_WARN,  "fetch: erro=%d" },
+    [LOG_FETCH_START_FAIL]     = { LOG_WARN,  "fetch: falha ao iniciar" },
+    [LOG_CORE1_START]          = { LOG_INFO,  "nucleo 1 iniciado" },
+    [LOG_UI_EVENT_DROPPED]     = { LOG_WARN,  "evento do botao %u descartado (fila cheia)" },
+    [LOG_WIFI_INIT_FAIL]       = { LOG_ERROR, "wifi: falha ao iniciar o cyw43" },
+    [LOG_WIFI_JOIN]            = { LOG_DEBUG, "wifi: associando (rapido=%u) rc=%d" },
+    [LOG_WIFI_UP]              = { LOG_INFO,  "wifi: conectado %i em %u ms (rapido=%u)" },
+    [LOG_WIFI_FAIL]            = { LOG_WARN,  "wifi: falha status=%d, nova tentativa em %u ms" },
+    [LOG_WIFI_FAST_FAIL]       = { LOG_INFO,  "wifi: caminho rapido falhou (status=%d), varrendo" },
+    [LOG_WIFI_LINK_LOST]       = { LOG_WARN,  "wifi: enlace perdido" },
+};
+
+static const char *const level_names[] = { "DEBUG", "INFO", "WARN", "ERRO" };
+
+// Muda se o layout mudar: anéis de outro firmware são descartados
+#define LOG_MAGIC (0x4C4F4721u ^ (uint32_t)sizeof(log_rec_t) ^ (LOG_RING_LEN << 16))
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot;
+    struct {
+        volatile uint32_t head;  // seq do último registro gravado
+        log_rec_t rec[LOG_RING_LEN];
+    } ring[LOG_CORES];
+} log_store_t;
+
+// Fora do .bss: não é zerado no boot
+static log_store_t __uninitialized_ram(store);
+
+void log_init(void) {
+    bool valid = store.magic == LOG_MAGIC;
+    for (uint c = 0; valid && c < LOG_CORES; c++) {
+        // Um head impossível indica RAM sem os dados de um boot anterior
+        uint32_t head = store.ring[c].head;
+        uint32_t last = head ? store.ring[c].rec[(head - 1) & (LOG_RING_LEN - 1)].seq : 0;
+        valid = (last == head || last == 0);
+    }
+    if (valid) {
+        store.boot++;
+    } else {
+        memset(&store, 0, sizeof(store));
+        store.magic = LOG_MAGIC;
+    }
+    LOG2(LOG_BOOT, store.boot, watchdog_caused_reboot());
+}
+
+void log_write(log_id_t id, uint32_t a0, uint32_t a1, uint32_t a2) {
+    uint core = get_core_num();
+    // Só protege contra IRQs do próprio núcleo; cada anel tem um núcleo
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t seq = store.ring[core].head + 1;
+    log_rec_t *r = &store.ring[core].rec[(seq - 1) & (LOG_RING_LEN - 1)];
+    r->seq = 0;
+    __mem_fence_release();
+    r->t_us    = time_us_32();
+    r->id      = (uint16_t)id;
+    r->boot    = (uint8_t)store.boot;
+    r->core    = (uint8_t)core;
+    r->args[0] = a0;
+    r->args[1] = a1;
+    r->args[2] = a2;
+    __mem_fence_release();
+    r->seq = seq;
+    store.ring[core].head = seq;
+    restore_interrupts(irq);
+}
+
+static uint32_t oldest_seq(uint core) {
+    uint32_t head = store.ring[core].head;
+    return head > LOG_RING_LEN ? head - LOG_RING_LEN + 1 : 1;
+}
+
+void log_cursor_oldest(log_cursor_t *c) {
+    for (uint i = 0; i < LOG_CORES; i++) {
+        c->next[i] = oldest_seq(i);
+    }
+    c->lost = 0;
+}
+
+void log_cursor_latest(log_cursor_t *c) {
+    for (uint i = 0; i < LOG_CORES; i++) {
+        c->next[i] = store.ring[i].head + 1;
+    }
+    c->lost = 0;
+}
+
+// Copia o registro "seq" do anel; false se ainda não existe. Se foi
+// sobrescrito (ou está sendo gravado), pula para o mais antigo.
+static bool ring_peek(log_cursor_t *c, uint core, log_rec_t *out) {
+    while (true) {
+        uint32_t seq = c->next[core];
+        if (seq > store.ring[core].head) {
+            return false;
+        }
+        const log_rec_t *r = &store.ring[core].rec[(seq - 1) & (LOG_RING_LEN - 1)];
+        __mem_fence_acquire();
+        memcpy(out, (const void *)r, sizeof(*out));
+        __mem_fence_acquire();
+        if (out->seq == seq && r->seq == seq) {
+            return true;
+        }
+        uint32_t oldest = oldest_seq(core);
+        uint32_t skip = oldest > seq ? oldest : seq + 1;
+        c->lost += skip - seq;
+        c->next[core] = skip;
+    }
+}
+
+bool log_next(log_cursor_t *c, log_rec_t *out) {
+    log_rec_t cand[LOG_CORES];
+    int best = -1;
+    for (uint i = 0; i < LOG_CORES; i++) {
+        if (!ring_peek(c, i, &cand[i])) {
+            continue;
+        }
+        if (best < 0) {
+            best = i;
+            continue;
+        }
+        int8_t dboot = (int8_t)(cand[i].boot - cand[best].boot);
+        if (dboot < 0 || (dboot == 0 && (int32_t)(cand[i].t_us - cand[best].t_us) < 0)) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return false;
+    }
+    *out = cand[best];
+    c->next[best]++;
+    return true;
+}
+
+log_level_t log_level(const log_rec_t *r) {
+    return r->id < LOG_ID_COUNT ? (log_level_t)catalog[r->id].level : LOG_INFO;
+}
+
+bool log_parse_level(const char *s, log_level_t *out) {
+    static const char *const names[] = { "debug", "info", "warn", "error" };
+    for (uint i = 0; i < count_of(names); i++) {
+        if (strcmp(s, names[i]) == 0) {
+            *out = (log_level_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t log_format(const log_rec_t *r, char *buf, size_t cap) {
+    int pos = snprintf(buf, cap, "%u:%lu.%06lu c%u %-5s ", r->boot,
+                       (unsigned long)(r->t_us / 1000000), (unsigned long)(r->t_us % 1000000),
+                       r->core, level_names[log_level(r)]);
+    const char *fmt = r->id < LOG_ID_COUNT ? catalog[r->id].fmt : NULL;
+    if (!fmt) {
+        // Registro de um firmware mais novo: só os valores crus
+        pos += snprintf(buf + pos, pos < (int)cap ? cap - pos : 0, "id=%u %lu %lu %lu",
+                        r->id, (unsigned long)r->args[0], (unsigned long)r->args[1], (unsigned long)r->args[2]);
+        fmt = "";
+    }
+    uint arg = 0;
+    for (const char *f = fmt; *f && pos >= 0 && (size_t)pos < cap; f++) {
+        if (f[0] != '%' || !f[1]) {
+            buf[pos++] = *f;
+            continue;
+        }
+        f++;
+        uint32_t v = arg < 3 ? r->args[arg] : 0;
+        size_t room = cap - pos;
+        switch (*f) {
+            case 'd': pos += snprintf(buf + pos, room, "%ld", (long)(int32_t)v); arg++; break;
+            case 'u': pos += snprintf(buf + pos, room, "%lu", (unsigned long)v); arg++; break;
+            case 'x': pos += snprintf(buf + pos, room, "%lx", (unsigned long)v); arg++; break;
+            case 'i': pos += snprintf(buf + pos, room, "%u.%u.%u.%u", (uint)(v & 0xFF),
+                                      (uint)(v >> 8 & 0xFF), (uint)(v >> 16 & 0xFF), (uint)(v >> 24)); arg++; break;
+            case 'f': {
+                union { uint32_t u; float f; } fv = { .u = v };
+                pos += snprintf(buf + pos, room, "%.2f", (double)fv.f);
+                arg++;
+                break;
+            }
+            default:  buf[pos++] = *f; break;
+        }
+    }
+    if (pos < 0 || (size_t)pos + 1 >= cap) {
+        return 0;
+    }
+    buf[pos++] = '\n';
+    return (size_t)pos;
+}
@@ -0,0 +1,107 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// =====================
+//  LOG BINÁRIO EM ANEL
+// =====================
+// Cada núcleo grava registros binários (id do catálogo + até 3 argumentos
+// de 32 bits) no seu próprio anel, sem lock e sem formatar nada; o mais
+// antigo é sobrescrito. A formatação acontece só na drenagem (USB/UART em
+// tempo ocioso e GET /api/log). Os anéis ficam em RAM não inicializada:
+// depois de um reset sem perda de energia (watchdog, reboot) o histórico
+// do boot anterior continua disponível.
+
+#define LOG_CORES    2
+#define LOG_RING_LEN 128  // registros por núcleo (potência de 2)
+
+typedef enum {
+    LOG_DEBUG = 0,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR,
+} log_level_t;
+
+// Catálogo: novos ids só no fim, para que registros de um firmware
+// anterior ainda sejam lidos com o formato certo
+typedef enum {
+    LOG_BOOT = 0,           // boot n (watchdog)
+    LOG_FLASH_MOUNT_FAIL,
+    LOG_HTTP_LISTENING,     // porta
+    LOG_HTTP_PCB_FAIL,
+    LOG_HTTP_BIND_FAIL,     // porta
+    LOG_FETCH_AUTO,
+    LOG_FETCH_UPDATE,       // via /update
+    LOG_FETCH_BUTTON,       // via botão
+    LOG_FETCH_BUSY,
+    LOG_FETCH_NO_SLOT,
+    LOG_FETCH_PCB_FAIL,
+    LOG_FETCH_CONNECT_FAIL, // err_t
+    LOG_FETCH_CONNECTED_FAIL,
+    LOG_FETCH_SEND_FAIL,    // err_t
+    LOG_FETCH_OK,           // temperatura, umidade
+    LOG_FETCH_PARSE_FAIL,
+    LOG_FETCH_NO_JSON,
+    LOG_FETCH_ERR,          // err_t
+    LOG_FETCH_START_FAIL,
+    LOG_CORE1_START,
+    LOG_UI_EVENT_DROPPED,   // botão
+    LOG_WIFI_INIT_FAIL,
+    LOG_WIFI_JOIN,          // caminho rápido, código de retorno
+    LOG_WIFI_UP,            // IP, duração (ms), caminho rápido
+    LOG_WIFI_FAIL,          // status do enlace, espera (ms)
+    LOG_WIFI_FAST_FAIL,     // status do enlace
+    LOG_WIFI_LINK_LOST,
+    LOG_ID_COUNT
+} log_id_t;
+
+typedef struct {
+    volatile uint32_t seq;  // 1, 2, ... (0 = registro sendo gravado)
+    uint32_t t_us;          // time_us_32() no momento do registro
+    uint16_t id;            // log_id_t
+    uint8_t  boot;          // boot em que foi gravado (mod 256)
+    uint8_t  core;
+    uint32_t args[3];
+} log_rec_t;
+
+typedef struct {
+    uint32_t next[LOG_CORES]; // próximo seq de cada anel
+    uint32_t lost;            // registros sobrescritos antes da leitura
+} log_cursor_t;
+
+// Valida os anéis herdados do boot anterior (ou zera) e registra LOG_BOOT
+void log_init(void);
+
+// Caminho rápido: qualquer núcleo, inclusive em IRQ
+void log_write(log_id_t id, uint32_t a0, uint32_t a1, uint32_t a2);
+
+#define LOG(id)             log_write((id), 0, 0, 0)
+#define LOG1(id, a)         log_write((id), (uint32_t)(a), 0, 0)
+#define LOG2(id, a, b)      log_write((id), (uint32_t)(a), (uint32_t)(b), 0)
+#define LOG3(id, a, b, c)   log_write((id), (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+// Argumento float (%f no formato)
+static inline uint32_t log_f32(float f) {
+    union { float f; uint32_t u; } v = { .f = f };
+    return v.u;
+}
+
+// Cursor no registro mais antigo ainda presente em cada anel
+void log_cursor_oldest(log_cursor_t *c);
+// Cursor só nos registros que ainda vão chegar
+void log_cursor_latest(log_cursor_t *c);
+
+// Próximo registro em ordem de (boot, tempo) entre os núcleos
+bool log_next(log_cursor_t *c, log_rec_t *out);
+
+log_level_t log_level(const log_rec_t *r);
+bool        log_parse_level(const char *s, log_level_t *out);
+
+// "boot:segundos cN NIVEL mensagem\n"; 0 se não couber
+size_t log_format(const log_rec_t *r, char *buf, size_t cap);
+
+#endif
@@ -12,32 +12,36 @@ typedef struct pixel_t pixel_t;
 typedef pixel_t npLED_t; // Mudança de nome de "struct pixel_t" para "npLED_t" por clareza.
 
 
-// Declaração do buffer de pixels que formam a matriz.
-static npLED_t *leds;
+// Declaração do buffer de pixels que formam a matriz (estático, sem heap).
+#define NP_MAX_LEDS 25
+static npLED_t leds[NP_MAX_LEDS];
 static uint led_count;
 
 // Variáveis para uso da máquina PIO.
 static PIO np_pio;
 static uint np_sm;
 
+// Brilho global (255 = cores sem alteração), aplicado só na escrita.
+static uint8_t np_brightness = 255;
+
 /**
  * Inicializa a máquina PIO para controle da matriz de LEDs.
  */
 void npInit(uint pin, uint amount) {
 
-  led_count = amount;
-  leds = (npLED_t *)calloc(led_count, sizeof(npLED_t));
+  led_count = amount < NP_MAX_LEDS ? amount : NP_MAX_LEDS;
 
   // Cria programa PIO.
   uint offset = pio_add_program(pio0, &ws2818b_program);
   np_pio = pio0;
 
   // Toma posse de uma máquina PIO.
-  np_sm = pio_claim_unused_sm(np_pio, false);
-  if (np_sm < 0) {
+  int sm = pio_claim_unused_sm(np_pio, false);
+  if (sm < 0) {
     np_pio = pio1;
-    np_sm = pio_claim_unused_sm(np_pio, true); // Se nenhuma máquina estiver livre, panic!
+    sm = pio_claim_unused_sm(np_pio, true); // Se nenhuma máquina estiver livre, panic!
   }
+  np_sm = (uint)sm;
 
   // Inicia programa na máquina PIO obtida.
   ws2818b_program_init(np_pio, np_sm, offset, pin, 800000.f);
@@ -67,15 +71,24 @@ void npClear() {
     npSetLED(i, 0, 0, 0);
 }
 
+/**
+ * Define o brilho global. O buffer guarda as cores originais; a escala
+ * vale a partir do próximo npWrite().
+ */
+void npSetBrightness(const uint8_t brightness) {
+  np_brightness = brightness;
+}
+
 /**
  * Escreve os dados do buffer nos LEDs.
  */
 void npWrite() {
+  const uint scale = np_brightness + 1;
   // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
   for (uint i = 0; i < led_count; ++i) {
-    pio_sm_put_blocking(np_pio, np_sm, leds[i].G);
-    pio_sm_put_blocking(np_pio, np_sm, leds[i].R);
-    pio_sm_put_blocking(np_pio, np_sm, leds[i].B);
+    pio_sm_put_blocking(np_pio, np_sm, (leds[i].G * scale) >> 8);
+    pio_sm_put_blocking(np_pio, np_sm, (leds[i].R * scale) >> 8);
+    pio_sm_put_blocking(np_pio, np_sm, (leds[i].B * scale) >> 8);
   }
   sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
 }
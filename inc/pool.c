@@ -0,0 +1,54 @@
+#include <string.h>
+#include "pool.h"
+
+static pool_t  *registry[POOL_MAX];
+static unsigned n_registered;
+
+void pool_init(pool_t *p) {
+    p->free_list = NULL;
+    // Encadeia de trás para frente: o primeiro pool_alloc() pega o bloco 0
+    for (uint32_t i = p->capacity; i-- > 0; ) {
+        void **blk = (void **)(p->mem + i * p->elem_size);
+        *blk = p->free_list;
+        p->free_list = blk;
+    }
+    p->in_use = 0;
+    p->high_water = 0;
+    p->exhausted = 0;
+
+    for (unsigned i = 0; i < n_registered; i++) {
+        if (registry[i] == p) {
+            return;
+        }
+    }
+    if (n_registered < POOL_MAX) {
+        registry[n_registered++] = p;
+    }
+}
+
+void *pool_alloc(pool_t *p) {
+    void **blk = (void **)p->free_list;
+    if (!blk) {
+        p->exhausted++;
+        return NULL;
+    }
+    p->free_list = *blk;
+    if (++p->in_use > p->high_water) {
+        p->high_water = p->in_use;
+    }
+    memset(blk, 0, p->elem_size);
+    return blk;
+}
+
+void pool_free(pool_t *p, void *obj) {
+    if (!obj) {
+        return;
+    }
+    *(void **)obj = p->free_list;
+    p->free_list = obj;
+    p->in_use--;
+}
+
+const pool_t *pool_get(unsigned i) {
+    return i < n_registered ? registry[i] : NULL;
+}
@@ -0,0 +1,52 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =====================
+//  POOLS DE OBJETOS
+// =====================
+// Blocos de tamanho fixo em memória estática, dimensionados na compilação.
+// Os blocos livres formam uma lista encadeada dentro deles mesmos, então
+// alocar e liberar custam O(1) e não há fragmentação. Cada pool conta o
+// pico de uso e as alocações recusadas, para ajuste a partir de campo.
+// Uso de um único núcleo (o contexto lwIP do núcleo 0).
+
+#define POOL_MAX 8 // pools registrados para pool_get()
+
+typedef struct {
+    const char *name;
+    uint8_t    *mem;
+    uint32_t    elem_size;
+    uint32_t    capacity;
+    void       *free_list;
+    uint32_t    in_use;
+    uint32_t    high_water;
+    uint32_t    exhausted;  // pool_alloc() sem bloco livre
+} pool_t;
+
+// Declara o armazenamento e o pool: POOL_DEFINE(g_conn_pool, conn_t, 4)
+#define POOL_DEFINE(var, type, count)                                  \
+    static type   var##_storage[count];                                \
+    static pool_t var = { .name = #var, .mem = (uint8_t *)var##_storage, \
+                          .elem_size = sizeof(type), .capacity = (count) }
+
+// Monta a lista livre e registra o pool (chamar uma vez no boot)
+void  pool_init(pool_t *p);
+
+// Bloco zerado ou NULL se o pool estiver esgotado
+void *pool_alloc(pool_t *p);
+void  pool_free(pool_t *p, void *obj);
+
+const pool_t *pool_get(unsigned i); // NULL após o último registrado
+
+#endif
+
+// Builds sem heap (APP_NO_HEAP, ligado no Release): qualquer malloc/free
+// no código da aplicação vira erro de compilação. Fora da guarda de
+// inclusão de propósito; incluir depois dos cabeçalhos do sistema.
+#if defined(APP_NO_HEAP) && APP_NO_HEAP
+#pragma GCC poison malloc calloc realloc free
+#endif
@@ -0,0 +1,542 @@
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_widgets.h"
+#include "ssd1306_scroll.h"
+#include "ipc.h"
+#include "app_state.h"
+#include "presentation.h"
+#include "prof.h"
+#include "log.h"
+
+// Biblioteca NeoPixel (só o núcleo 1 escreve na matriz)
+#include "neopixel.c"
+#include "pool.h" // APP_NO_HEAP: sem malloc/free daqui em diante
+
+static pres_config_t cfg;
+
+// núcleo 0 -> núcleo 1
+static pres_cmd_t   cmd_buf[PRES_CMD_QUEUE];
+static spsc_queue_t cmd_queue;
+
+// núcleo 1 -> núcleo 0
+static button_event_t event_buf[PRES_EVENT_QUEUE];
+static spsc_queue_t   event_queue;
+
+// Estado dos botões mantido pelo núcleo 1 e publicado em app_state
+static ui_state_t ui;
+static bool       ui_dirty;
+
+static alarm_pool_t *core1_pool;
+static volatile bool core1_ready;   // lockout da flash pronto (pres_start espera)
+static alarm_id_t    wake_alarm;
+static uint32_t      wake_target;   // instante pedido ao alarme (atraso em /metrics)
+
+// Telas do painel (B2 clique duplo troca com paginação vertical)
+enum { SCREEN_STATUS = 0, SCREEN_SYSTEM, SCREEN_COUNT };
+static uint8_t screen;
+static bool    screen_switch;
+
+// Letreiro na página 1 (livre nas duas telas)
+#define TICKER_PAGE 1
+static ssd1306_ticker_t ticker;
+static char             ticker_text[PRES_TEXT_MAX + 1];
+static ssd1306_pager_t  pager;
+static bool             ticker_restart;
+
+// Quadros remotos do OLED: o núcleo 0 monta em uma das duas áreas e
+// entrega com PRES_CMD_OLED; o núcleo 1 copia e devolve a área
+static uint8_t          oled_stage[2][ssd1306_buffer_length];
+static volatile bool    oled_stage_busy[2];
+static uint8_t          oled_stage_w;      // próxima área do núcleo 0
+static bool             oled_remote;       // tela controlada remotamente
+static uint32_t         oled_remote_until;
+
+// Escritas no framebuffer do display e no buffer da matriz, para leituras
+// consistentes pelo núcleo 0 (GET /api/oled, GET /api/leds)
+static seqlock_t        oled_lock;
+static seqlock_t        led_lock;
+
+// A matriz só é escrita depois de esvaziar a fila: vários quadros (ou
+// quadro + brilho) recebidos juntos custam uma única transferência
+static bool             leds_dirty;
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  DISPLAY
+// ~~~~~~~~~~~~~~~~~~~~~
+void pres_render_lines(const char *lines[], int count) {
+    struct render_area frame_area = {
+        .start_column = 0,
+        .end_column   = ssd1306_width - 1,
+        .start_page   = 0,
+        .end_page     = ssd1306_n_pages - 1
+    };
+    calculate_render_area_buffer_length(&frame_area);
+
+    uint8_t ssd[ssd1306_buffer_length];
+    memset(ssd, 0, sizeof(ssd));
+
+    int y = 0;
+    for (int i = 0; i < count; i++) {
+        ssd1306_draw_string(ssd, 5, y, (char *)lines[i]);
+        y += 8;
+    }
+    render_on_display(ssd, &frame_area);
+}
+
+// Painel: cada valor é um widget e só o que muda vai para a tela
+static const uint8_t icon_led[8] = { 0x00, 0x1C, 0x3E, 0x7F, 0x7F, 0x3E, 0x1C, 0x00 };
+
+static struct {
+    int ip, temp, temp_bar, umid, umid_bar, http, led, gesture;
+} dash;
+
+static struct {
+    int title, uptime, i2c, dropped, http;
+} sys;
+
+static void screen_build(uint8_t which) {
+    widgets_clear();
+    if (which == SCREEN_STATUS) {
+        dash.ip       = widget_add_text(0, 0, 16);
+        dash.temp     = widget_add_number(0, 2, 16, "TEMP", 2, "C");
+        dash.temp_bar = widget_add_bar(0, 3, ssd1306_width, 0, 5000);   // 0..50 C
+        dash.umid     = widget_add_number(0, 4, 16, "UMID", 2, "%");
+        dash.umid_bar = widget_add_bar(0, 5, ssd1306_width, 0, 10000);  // 0..100 %
+        dash.http     = widget_add_number(0, 6, 14, "HTTP", 0, "");
+        dash.led      = widget_add_icon(ssd1306_width - 8, 6, icon_led);
+        dash.gesture  = widget_add_text(0, 7, 16);
+    } else {
+        sys.title     = widget_add_text(0, 0, 16);
+        sys.uptime    = widget_add_number(0, 2, 16, "UPTIME", 0, "S");
+        sys.i2c       = widget_add_number(0, 3, 16, "I2C KB", 0, "");
+        sys.dropped   = widget_add_number(0, 4, 16, "PERDIDOS", 0, "");
+        sys.http      = widget_add_number(0, 5, 16, "HTTP", 0, "");
+        widget_set_text(sys.title, "SISTEMA");
+    }
+}
+
+static void screen_bind(const net_state_t *net) {
+    char buf[WIDGET_TEXT_MAX + 1];
+    if (screen == SCREEN_SYSTEM) {
+        widgets_stats_t ws;
+        widgets_get_stats(&ws);
+        widget_set_number(sys.uptime, (int32_t)(time_us_64() / 1000000));
+        widget_set_number(sys.i2c, (int32_t)(ws.bytes / 1024));
+        widget_set_number(sys.dropped, (int32_t)pres_events_dropped());
+        widget_set_number(sys.http, (int32_t)net->http_requests);
+        return;
+    }
+
+    const uint8_t *ip = (const uint8_t *)&net->ip;
+    if (net->ip) {
+        snprintf(buf, sizeof(buf), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+    } else {
+        snprintf(buf, sizeof(buf), "SEM WIFI");
+    }
+    widget_set_text(dash.ip, buf);
+
+    int32_t temp = (int32_t)lroundf(net->temperatura * 100.0f);
+    int32_t umid = (int32_t)lroundf(net->umidade * 100.0f);
+    widget_set_number(dash.temp, temp);
+    widget_set_bar(dash.temp_bar, temp);
+    widget_set_number(dash.umid, umid);
+    widget_set_bar(dash.umid_bar, umid);
+    widget_set_number(dash.http, (int32_t)net->http_requests);
+    widget_set_icon(dash.led, net->led_on);
+
+    // Último gesto entre os dois botões
+    int last = -1;
+    for (int i = 0; i < BUTTONS_MAX; i++) {
+        if (ui.seen[i] && (last < 0 || (int32_t)(ui.last[i].t_us - ui.last[last].t_us) > 0)) {
+            last = i;
+        }
+    }
+    buf[0] = '\0';
+    if (last >= 0) {
+        snprintf(buf, sizeof(buf), "B%d %s", last + 1,
+                 buttons_gesture_name((button_gesture_t)ui.last[last].gesture));
+    }
+    widget_set_text(dash.gesture, buf);
+}
+
+// O letreiro vai à tela pela rolagem do controlador; o framebuffer dos
+// widgets acompanha a página para GET /api/oled e para os quadros remotos
+// compararem com o que está de fato na tela
+static void ticker_mirror(void) {
+    seqlock_write_begin(&oled_lock);
+    widgets_shadow(TICKER_PAGE * ssd1306_width, ticker.shown, ssd1306_width);
+    seqlock_write_end(&oled_lock);
+}
+
+// Monta a próxima tela no framebuffer dos widgets e entrega à paginação,
+// que a envia uma página por vez enquanto a linha inicial avança
+static void screen_next(void) {
+    net_state_t net;
+    app_state_read_net(&net);
+    screen = (screen + 1) % SCREEN_COUNT;
+    seqlock_write_begin(&oled_lock);
+    screen_build(screen);
+    screen_bind(&net);
+    widgets_render();
+    seqlock_write_end(&oled_lock);
+    widgets_mark_flushed();
+    ticker.active = false;
+    ssd1306_pager_start(&pager, widgets_framebuffer());
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  NÚCLEO 1
+// ~~~~~~~~~~~~~~~~~~~~~
+static void handle_cmd(const pres_cmd_t *cmd) {
+    switch (cmd->type) {
+        case PRES_CMD_LEDS:
+        case PRES_CMD_LED_PATCH:
+            seqlock_write_begin(&led_lock);
+            for (uint i = 0; i < led_count; i++) {
+                if (i >= cmd->first && i - cmd->first < cmd->count) {
+                    const uint8_t *rgb = cmd->u.rgb[i - cmd->first];
+                    npSetLED(i, rgb[0], rgb[1], rgb[2]);
+                } else if (cmd->type == PRES_CMD_LEDS) {
+                    npSetLED(i, 0, 0, 0);
+                }
+            }
+            seqlock_write_end(&led_lock);
+            if (cmd->brightness != PRES_BRIGHTNESS_KEEP) {
+                npSetBrightness((uint8_t)cmd->brightness);
+            }
+            leds_dirty = true;
+            break;
+        case PRES_CMD_TICKER:
+            snprintf(ticker_text, sizeof(ticker_text), "%s", cmd->u.text);
+            // Durante a paginação ou a tela remota o letreiro espera
+            if (!pager.active && !oled_remote) {
+                ssd1306_ticker_start(&ticker, TICKER_PAGE, ticker_text);
+                ticker_mirror();
+            }
+            break;
+        case PRES_CMD_OLED: {
+            uint8_t idx = cmd->u.oled.stage & 1;
+            seqlock_write_begin(&oled_lock);
+            widgets_blit(cmd->u.oled.offset, &oled_stage[idx][cmd->u.oled.offset], cmd->u.oled.len);
+            seqlock_write_end(&oled_lock);
+            __mem_fence_release();
+            oled_stage_busy[idx] = false;
+            // O painel e o letreiro param enquanto chegarem quadros
+            oled_remote = true;
+            oled_remote_until = time_us_32() + PRES_REMOTE_HOLD_MS * 1000;
+            ticker.active = false;
+            break;
+        }
+    }
+}
+
+// Assinante dos botões no núcleo 1: atualiza o instantâneo e repassa
+// o evento ao núcleo 0
+static void on_button(const button_event_t *ev, void *ctx) {
+    if (ev->button < BUTTONS_MAX) {
+        ui.pressed[ev->button] = buttons_is_pressed(ev->button);
+        ui.last[ev->button] = *ev;
+        ui.seen[ev->button] = true;
+        app_state_publish_ui(&ui);
+        if (ev->gesture != BUTTON_HOLD_REPEAT) {
+            ui_dirty = true;
+        }
+        if (ev->button == 1 && ev->gesture == BUTTON_DOUBLE_CLICK) {
+            screen_switch = true;
+        }
+    }
+    if (!spsc_push(&event_queue, ev)) {
+        LOG1(LOG_UI_EVENT_DROPPED, ev->button);
+    } else if (cfg.on_event) {
+        cfg.on_event();
+    }
+}
+
+// Só serve para tirar o núcleo do WFE; a entrada na IRQ já o acorda
+static int64_t wake_alarm_cb(alarm_id_t id, void *user_data) {
+    wake_alarm = 0;
+    return 0;
+}
+
+static bool due(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+// Menor espera (ms) entre "wait_ms" (0 = nenhuma) e o prazo "deadline"
+static uint32_t min_wait(uint32_t wait_ms, uint32_t now, uint32_t deadline) {
+    int32_t left_us = (int32_t)(deadline - now);
+    uint32_t ms = left_us > 0 ? (uint32_t)(left_us + 999) / 1000 : 1;
+    return (wait_ms == 0 || ms < wait_ms) ? ms : wait_ms;
+}
+
+static void core1_main(void) {
+    // Permite ao núcleo 0 pausar este núcleo durante gravações na flash
+    flash_safe_execute_core_init();
+    __mem_fence_release();
+    core1_ready = true;
+    __sev();
+
+    // Alarmes (debounce e timeouts de gesto) com IRQ neste núcleo
+    core1_pool = alarm_pool_create_with_unused_hardware_alarm(8);
+    LOG(LOG_CORE1_START);
+
+    npInit(cfg.led_pin, cfg.led_count);
+    npClear();
+    npWrite();
+
+    buttons_subscribe(on_button, NULL);
+    buttons_init(cfg.button_pins, cfg.button_count, NULL, core1_pool);
+    for (uint i = 0; i < cfg.button_count && i < BUTTONS_MAX; i++) {
+        ui.pressed[i] = buttons_is_pressed(i);
+    }
+    app_state_publish_ui(&ui);
+
+    widgets_init();
+    screen_build(SCREEN_STATUS);
+    uint32_t drawn_version = app_state_net_version();
+    ui_dirty = true;
+
+    uint32_t ticker_due = time_us_32();
+    uint32_t pager_due  = ticker_due;
+    uint32_t system_due = ticker_due;
+
+    while (true) {
+        pres_cmd_t cmd;
+        while (spsc_pop(&cmd_queue, &cmd)) {
+            handle_cmd(&cmd);
+        }
+        if (leds_dirty) {
+            leds_dirty = false;
+            PROF_BEGIN(t_np);
+            npWrite();
+            PROF_END(PROF_NP_WRITE, t_np);
+        }
+
+        uint32_t wait_ms = buttons_process();
+        uint32_t now = time_us_32();
+        if (wake_target && due(now, wake_target)) {
+            PROF_RECORD(PROF_CORE1_LAG, now - wake_target);
+            wake_target = 0;
+        }
+
+        // Tela remota: os quadros recebidos nesta volta saem juntos
+        if (oled_remote) {
+            if (due(now, oled_remote_until)) {
+                oled_remote = false;
+                seqlock_write_begin(&oled_lock);
+                screen_build(screen);
+                seqlock_write_end(&oled_lock);
+                ui_dirty = true;
+                ticker_restart = true;
+            } else {
+                PROF_BEGIN(t_flush);
+                widgets_flush();
+                PROF_END(PROF_OLED_FLUSH, t_flush);
+                wait_ms = min_wait(wait_ms, now, oled_remote_until);
+            }
+        }
+
+        if (screen_switch && !pager.active && !oled_remote) {
+            screen_switch = false;
+            screen_next();
+            pager_due = now;
+        }
+
+        if (pager.active) {
+            // Widgets e letreiro ficam parados até a nova tela entrar
+            if (due(now, pager_due)) {
+                PROF_BEGIN(t_page);
+                bool paging = ssd1306_pager_step(&pager, 2);
+                PROF_END(PROF_OLED_SCROLL, t_page);
+                if (!paging) {
+                    ticker_restart = true;
+                    ui_dirty = true;
+                }
+                pager_due = now + SSD1306_PAGER_STEP_MS * 1000;
+            }
+            if (pager.active) {
+                wait_ms = min_wait(wait_ms, now, pager_due);
+            }
+        }
+
+        if (!pager.active && !oled_remote) {
+            // A tela de sistema mostra o uptime: redesenha a cada segundo
+            if (screen == SCREEN_SYSTEM) {
+                if (due(now, system_due)) {
+                    ui_dirty = true;
+                    system_due = now + 1000 * 1000;
+                }
+                wait_ms = min_wait(wait_ms, now, system_due);
+            }
+
+            uint32_t version = app_state_net_version();
+            if (ui_dirty || version != drawn_version) {
+                net_state_t net;
+                app_state_read_net(&net);
+                PROF_BEGIN(t_render);
+                seqlock_write_begin(&oled_lock);
+                screen_bind(&net);
+                widgets_render();
+                seqlock_write_end(&oled_lock);
+                PROF_END(PROF_OLED_RENDER, t_render);
+                PROF_BEGIN(t_flush);
+                widgets_flush();
+                PROF_END(PROF_OLED_FLUSH, t_flush);
+                drawn_version = version;
+                ui_dirty = false;
+            }
+
+            // Depois do redesenho completo, para não ser apagado por ele
+            if (ticker_restart) {
+                ticker_restart = false;
+                ssd1306_ticker_start(&ticker, TICKER_PAGE, ticker_text);
+                ticker_mirror();
+                ticker_due = now;
+            }
+
+            if (ticker.active) {
+                if (due(now, ticker_due)) {
+                    PROF_BEGIN(t_tick);
+                    ssd1306_ticker_step(&ticker);
+                    ticker_mirror();
+                    PROF_END(PROF_OLED_SCROLL, t_tick);
+                    ticker_due = now + SSD1306_TICKER_STEP_MS * 1000;
+                }
+                wait_ms = min_wait(wait_ms, now, ticker_due);
+            }
+        }
+
+        if (wake_alarm > 0) {
+            alarm_pool_cancel_alarm(core1_pool, wake_alarm);
+            wake_alarm = 0;
+        }
+        wake_target = 0;
+        if (wait_ms) {
+            wake_alarm = alarm_pool_add_alarm_in_ms(core1_pool, wait_ms, wake_alarm_cb, NULL, true);
+            wake_target = (time_us_32() + wait_ms * 1000) | 1; // 0 = sem alarme
+        }
+        // Acorda com IRQ (GPIO/alarme) ou __sev() do núcleo 0; um evento
+        // sinalizado entre a checagem das filas e o WFE não se perde
+        __wfe();
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~
+//  API do NÚCLEO 0
+// ~~~~~~~~~~~~~~~~~~~~~
+void pres_start(const pres_config_t *config) {
+    cfg = *config;
+    spsc_init(&cmd_queue, cmd_buf, sizeof(pres_cmd_t), PRES_CMD_QUEUE);
+    spsc_init(&event_queue, event_buf, sizeof(button_event_t), PRES_EVENT_QUEUE);
+    multicore_launch_core1(core1_main);
+    // Antes disso flash_safe_execute() não consegue pausar o núcleo 1 e
+    // recusa gravar (PICO_ERROR_NOT_PERMITTED)
+    while (!core1_ready) {
+        __wfe();
+    }
+    __mem_fence_acquire();
+}
+
+static bool send_cmd(const pres_cmd_t *cmd) {
+    if (!spsc_push(&cmd_queue, cmd)) {
+        return false;
+    }
+    __sev();
+    return true;
+}
+
+bool pres_set_leds(const uint8_t rgb[][3], uint count) {
+    return pres_set_scene(rgb, count, -1);
+}
+
+bool pres_set_scene(const uint8_t rgb[][3], uint count, int brightness) {
+    pres_cmd_t cmd = { .type = PRES_CMD_LEDS };
+    cmd.count = count < PRES_LED_MAX ? count : PRES_LED_MAX;
+    cmd.brightness = (brightness < 0) ? PRES_BRIGHTNESS_KEEP : (uint16_t)(brightness > 255 ? 255 : brightness);
+    memcpy(cmd.u.rgb, rgb, cmd.count * 3);
+    return send_cmd(&cmd);
+}
+
+bool pres_patch_leds(uint first, const uint8_t rgb[][3], uint count) {
+    if (first >= PRES_LED_MAX) {
+        return false;
+    }
+    pres_cmd_t cmd = { .type = PRES_CMD_LED_PATCH, .first = (uint8_t)first, .brightness = PRES_BRIGHTNESS_KEEP };
+    cmd.count = count < PRES_LED_MAX - first ? count : PRES_LED_MAX - first;
+    memcpy(cmd.u.rgb, rgb, cmd.count * 3);
+    return send_cmd(&cmd);
+}
+
+uint pres_read_leds(uint8_t rgb[][3], uint cap) {
+    uint n = led_count < cap ? led_count : cap;
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&led_lock);
+        for (uint i = 0; i < n; i++) {
+            rgb[i][0] = leds[i].R;
+            rgb[i][1] = leds[i].G;
+            rgb[i][2] = leds[i].B;
+        }
+    } while (seqlock_read_retry(&led_lock, seq));
+    return n;
+}
+
+uint8_t *pres_oled_stage(void) {
+    if (oled_stage_busy[oled_stage_w]) {
+        return NULL;
+    }
+    __mem_fence_acquire();
+    return oled_stage[oled_stage_w];
+}
+
+bool pres_oled_commit(uint16_t offset, uint16_t len) {
+    if (offset >= ssd1306_buffer_length || len > ssd1306_buffer_length - offset) {
+        return false;
+    }
+    pres_cmd_t cmd = { .type = PRES_CMD_OLED };
+    cmd.u.oled.stage  = oled_stage_w;
+    cmd.u.oled.offset = offset;
+    cmd.u.oled.len    = len;
+    oled_stage_busy[oled_stage_w] = true;
+    if (!send_cmd(&cmd)) {
+        oled_stage_busy[oled_stage_w] = false;
+        return false;
+    }
+    oled_stage_w ^= 1;
+    return true;
+}
+
+void pres_read_oled(uint8_t *dst, uint16_t offset, uint16_t len) {
+    const uint8_t *fb = widgets_framebuffer();
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&oled_lock);
+        memcpy(dst, fb + offset, len);
+    } while (seqlock_read_retry(&oled_lock, seq));
+}
+
+bool pres_set_ticker(const char *text) {
+    pres_cmd_t cmd = { .type = PRES_CMD_TICKER };
+    snprintf(cmd.u.text, sizeof(cmd.u.text), "%s", text ? text : "");
+    return send_cmd(&cmd);
+}
+
+void pres_wake(void) {
+    __sev();
+}
+
+bool pres_pop_event(button_event_t *ev) {
+    return spsc_pop(&event_queue, ev);
+}
+
+uint32_t pres_events_dropped(void) {
+    return event_queue.dropped + buttons_dropped();
+}
@@ -0,0 +1,103 @@
+#ifndef PRESENTATION_H
+#define PRESENTATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "buttons.h"
+
+// =====================
+//  APRESENTAÇÃO (NÚCLEO 1)
+// =====================
+// O núcleo 1 é dono do display SSD1306, da matriz NeoPixel e dos botões.
+// O núcleo 0 (Wi-Fi, lwIP, HTTP, flash) conversa com ele só por filas SPSC
+// e pelos instantâneos de app_state:
+//   núcleo 0 -> 1: pres_cmd_t (quadros de LED) + __sev() para acordá-lo;
+//                  produtor único: o async_context (ou quem segura o lock
+//                  dele, como o boot depois de pres_start)
+//   núcleo 1 -> 0: button_event_t, avisados pelo callback "on_event"
+// O FIFO do SIO fica livre para o lockout usado nas gravações da flash.
+
+#define PRES_LED_MAX      25
+#define PRES_CMD_QUEUE    8   // potência de 2
+#define PRES_EVENT_QUEUE  32  // potência de 2
+#define PRES_TEXT_MAX     64  // letreiro
+#define PRES_REMOTE_HOLD_MS 10000 // tela remota sem novos quadros volta ao painel
+#define PRES_BRIGHTNESS_KEEP 0xFFFF // pres_cmd_t.brightness: mantém o atual
+
+typedef enum {
+    PRES_CMD_LEDS = 0,  // novo quadro para a matriz NeoPixel
+    PRES_CMD_TICKER,    // novo texto do letreiro do display
+    PRES_CMD_LED_PATCH, // altera só os LEDs [first, first+count)
+    PRES_CMD_OLED,      // aplica uma faixa da área de montagem do OLED
+} pres_cmd_type_t;
+
+typedef struct {
+    uint8_t  type;       // pres_cmd_type_t
+    uint8_t  first;      // primeiro LED (PRES_CMD_LED_PATCH)
+    uint8_t  count;      // LEDs válidos em rgb[]
+    uint16_t brightness; // LEDs: novo brilho 0-255 ou PRES_BRIGHTNESS_KEEP
+    union {
+        uint8_t rgb[PRES_LED_MAX][3];
+        char    text[PRES_TEXT_MAX + 1];
+        struct {
+            uint8_t  stage;
+            uint16_t offset;
+            uint16_t len;
+        } oled;
+    } u;
+} pres_cmd_t;
+
+typedef struct {
+    uint        led_pin;      // dados da matriz NeoPixel
+    uint        led_count;
+    const uint *button_pins;
+    uint        button_count;
+    // Chamado no núcleo 1 quando há eventos de botão na fila; deve só
+    // agendar o consumo no núcleo 0 (p.ex. async_context_set_work_pending)
+    void      (*on_event)(void);
+} pres_config_t;
+
+// Núcleo 0, antes de pres_start(): desenha linhas de texto direto no display
+void pres_render_lines(const char *lines[], int count);
+
+// Lança o núcleo 1; a partir daqui o display e a matriz são dele. Retorna
+// quando ele já pode ser pausado: só então a flash pode ser gravada.
+void pres_start(const pres_config_t *cfg);
+
+// Núcleo 0: envia um quadro (RGB por LED). false se a fila estiver cheia.
+bool pres_set_leds(const uint8_t rgb[][3], uint count);
+
+// Núcleo 0: quadro completo e brilho (0-255, ou -1 para manter) aplicados
+// juntos, numa única escrita na fita
+bool pres_set_scene(const uint8_t rgb[][3], uint count, int brightness);
+
+// Núcleo 0: altera só parte da matriz
+bool pres_patch_leds(uint first, const uint8_t rgb[][3], uint count);
+
+// Núcleo 0: cópia consistente do buffer da matriz; devolve quantos LEDs
+uint pres_read_leds(uint8_t rgb[][3], uint cap);
+
+// Núcleo 0: quadros remotos do OLED (formato de páginas do SSD1306).
+// pres_oled_stage() devolve a área de montagem livre (NULL se o núcleo 1
+// ainda não consumiu as duas); os bytes ficam na mesma posição do
+// framebuffer e pres_oled_commit() entrega a faixa [offset, offset+len),
+// aplicada de uma vez no próximo quadro.
+uint8_t *pres_oled_stage(void);
+bool     pres_oled_commit(uint16_t offset, uint16_t len);
+
+// Núcleo 0: cópia consistente de uma faixa do framebuffer do OLED
+void     pres_read_oled(uint8_t *dst, uint16_t offset, uint16_t len);
+
+// Núcleo 0: texto do letreiro rolado por hardware (vazio = apaga)
+bool pres_set_ticker(const char *text);
+
+// Núcleo 0: acorda o núcleo 1 (p.ex. após publicar um novo net_state_t)
+void pres_wake(void);
+
+// Núcleo 0: consome os eventos de botão vindos do núcleo 1
+bool pres_pop_event(button_event_t *ev);
+
+uint32_t pres_events_dropped(void);
+
+#endif
@@ -0,0 +1,60 @@
+#include <string.h>
+#include "ipc.h"
+#include "prof.h"
+
+const uint32_t prof_bucket_le_us[PROF_BUCKETS - 1] = {
+    10, 50, 100, 500, 1000, 5000, 20000
+};
+
+static const char *const names[PROF_SCOPE_COUNT] = {
+    [PROF_HTTP_CALLBACK] = "http_callback",
+    [PROF_HTTP_STATIC]   = "http_static",
+    [PROF_PARSE_JSON]    = "parse_json",
+    [PROF_CORE0_LAG]     = "core0_lag",
+    [PROF_OLED_RENDER]   = "oled_render",
+    [PROF_OLED_FLUSH]    = "oled_flush",
+    [PROF_OLED_SCROLL]   = "oled_scroll",
+    [PROF_NP_WRITE]      = "np_write",
+    [PROF_CORE1_LAG]     = "core1_lag",
+};
+
+#if PROF_ENABLED
+static struct {
+    seqlock_t    lock;
+    prof_stats_t s;
+} scopes[PROF_SCOPE_COUNT];
+#endif
+
+void prof_record(prof_scope_id_t id, uint32_t us) {
+#if PROF_ENABLED
+    uint b = 0;
+    while (b < PROF_BUCKETS - 1 && us > prof_bucket_le_us[b]) {
+        b++;
+    }
+    prof_stats_t *s = &scopes[id].s;
+    seqlock_write_begin(&scopes[id].lock);
+    s->count++;
+    s->total_us += us;
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->hist[b]++;
+    seqlock_write_end(&scopes[id].lock);
+#endif
+}
+
+void prof_read(prof_scope_id_t id, prof_stats_t *out) {
+#if PROF_ENABLED
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&scopes[id].lock);
+        *out = scopes[id].s;
+    } while (seqlock_read_retry(&scopes[id].lock, seq));
+#else
+    memset(out, 0, sizeof(*out));
+#endif
+}
+
+const char *prof_scope_name(prof_scope_id_t id) {
+    return id < PROF_SCOPE_COUNT ? names[id] : "?";
+}
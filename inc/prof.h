@@ -0,0 +1,61 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// =====================
+//  PERFIL DE TEMPO (escopos)
+// =====================
+// Cada escopo nomeado acumula chamadas, tempo total, máximo e um
+// histograma em microssegundos, medidos pelo timer de 1 MHz. Cada escopo
+// tem um único escritor (núcleo fixo); a leitura pelo núcleo 0 usa
+// seqlock. Com PROF_ENABLED = 0 as macros somem e nada é medido.
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 1
+#endif
+
+typedef enum {
+    PROF_HTTP_CALLBACK = 0,  // núcleo 0: recepção de um segmento HTTP
+    PROF_HTTP_STATIC,        // núcleo 0: resposta de um arquivo da interface
+    PROF_PARSE_JSON,         // núcleo 0: resposta de /dados
+    PROF_CORE0_LAG,          // núcleo 0: atraso de um worker periódico
+    PROF_OLED_RENDER,        // núcleo 1: widgets_render()
+    PROF_OLED_FLUSH,         // núcleo 1: envio I2C das faixas sujas
+    PROF_OLED_SCROLL,        // núcleo 1: passo do letreiro/paginação
+    PROF_NP_WRITE,           // núcleo 1: npWrite()
+    PROF_CORE1_LAG,          // núcleo 1: atraso ao acordar pelo alarme
+    PROF_SCOPE_COUNT
+} prof_scope_id_t;
+
+// Limites superiores (us) dos baldes; o último balde é +Inf
+#define PROF_BUCKETS 8
+extern const uint32_t prof_bucket_le_us[PROF_BUCKETS - 1];
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint32_t hist[PROF_BUCKETS]; // não cumulativo
+} prof_stats_t;
+
+#if PROF_ENABLED
+#define PROF_BEGIN(t)       uint32_t t = time_us_32()
+#define PROF_END(id, t)     prof_record((id), time_us_32() - (t))
+#define PROF_RECORD(id, us) prof_record((id), (us))
+#else
+#define PROF_BEGIN(t)       do { } while (0)
+#define PROF_END(id, t)     do { } while (0)
+#define PROF_RECORD(id, us) do { } while (0)
+#endif
+
+void prof_record(prof_scope_id_t id, uint32_t us);
+
+// Cópia consistente de um escopo (zerada se PROF_ENABLED = 0)
+void prof_read(prof_scope_id_t id, prof_stats_t *out);
+
+const char *prof_scope_name(prof_scope_id_t id);
+
+#endif
@@ -0,0 +1,75 @@
+#include <string.h>
+#include "rle.h"
+
+enum {
+    RLE_HEADER = 0,
+    RLE_LITERAL,
+    RLE_REPEAT,
+};
+
+void rle_decoder_init(rle_decoder_t *d, uint8_t *dst, uint32_t cap, bool raw) {
+    d->dst      = dst;
+    d->cap      = cap;
+    d->pos      = 0;
+    d->mode     = RLE_HEADER;
+    d->left     = 0;
+    d->raw      = raw;
+    d->overflow = false;
+}
+
+static bool emit(rle_decoder_t *d, const uint8_t *src, size_t n) {
+    if (n > d->cap - d->pos) {
+        d->overflow = true;
+        return false;
+    }
+    memcpy(d->dst + d->pos, src, n);
+    d->pos += n;
+    return true;
+}
+
+bool rle_decode(rle_decoder_t *d, const uint8_t *src, size_t len) {
+    if (d->overflow) {
+        return false;
+    }
+    if (d->raw) {
+        return emit(d, src, len);
+    }
+    const uint8_t *end = src + len;
+    while (src < end) {
+        switch (d->mode) {
+            case RLE_HEADER: {
+                uint8_t n = *src++;
+                if (n < 128) {
+                    d->mode = RLE_LITERAL;
+                    d->left = n + 1;
+                } else if (n > 128) {
+                    d->mode = RLE_REPEAT;
+                    d->left = (uint8_t)(257 - n);
+                }
+                break;
+            }
+            case RLE_LITERAL: {
+                size_t n = (size_t)(end - src) < d->left ? (size_t)(end - src) : d->left;
+                if (!emit(d, src, n)) {
+                    return false;
+                }
+                src += n;
+                d->left -= n;
+                if (d->left == 0) {
+                    d->mode = RLE_HEADER;
+                }
+                break;
+            }
+            case RLE_REPEAT:
+                if (d->left > d->cap - d->pos) {
+                    d->overflow = true;
+                    return false;
+                }
+                memset(d->dst + d->pos, *src++, d->left);
+                d->pos += d->left;
+                d->mode = RLE_HEADER;
+                break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef RLE_H
+#define RLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =====================
+//  DECODIFICADOR RLE (PackBits)
+// =====================
+// Cada bloco começa com um byte n:
+//   0..127   -> copia os próximos n+1 bytes
+//   129..255 -> repete o próximo byte 257-n vezes
+//   128      -> ignorado
+// O decodificador guarda o estado entre chamadas, então o corpo de uma
+// requisição pode ser consumido segmento a segmento, direto no destino.
+
+typedef struct {
+    uint8_t *dst;
+    uint32_t cap;
+    uint32_t pos;       // bytes já escritos em dst
+    uint8_t  mode;      // interno
+    uint8_t  left;      // bytes restantes do bloco atual
+    bool     raw;       // sem compressão: copia direto
+    bool     overflow;  // os dados passaram de "cap"
+} rle_decoder_t;
+
+void rle_decoder_init(rle_decoder_t *d, uint8_t *dst, uint32_t cap, bool raw);
+
+// Consome "len" bytes; devolve false se o destino estourou
+bool rle_decode(rle_decoder_t *d, const uint8_t *src, size_t len);
+
+#endif
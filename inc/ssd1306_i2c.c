@@ -7,6 +7,11 @@
 #include "hardware/i2c.h"
 #include "ssd1306_font.h"
 #include "ssd1306_i2c.h"
+#include "pool.h"
+
+// Buffers estáticos: nenhuma alocação por quadro enviado
+static uint8_t send_buffer[ssd1306_buffer_length + 1];
+static uint8_t bm_buffer[ssd1306_buffer_length + 1];
 
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
@@ -26,16 +31,15 @@ void ssd1306_send_command_list(uint8_t *ssd, int number) {
     }
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
+// Copia buffer de referência num buffer estático, a fim de adicionar o byte de controle desde o início
 void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
-
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
-
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+    if (buffer_length > (int)ssd1306_buffer_length) {
+        buffer_length = ssd1306_buffer_length;
+    }
+    send_buffer[0] = 0x40;
+    memcpy(send_buffer + 1, ssd, buffer_length);
 
-    free(temp_buffer);
+    i2c_write_blocking(i2c1, ssd1306_i2c_address, send_buffer, buffer_length + 1, false);
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
@@ -74,6 +78,23 @@ void ssd1306_scroll(bool set) {
     ssd1306_send_command_list(commands, count_of(commands));
 }
 
+// Desloca o conteúdo das páginas em uma única coluna (sem rolagem contínua).
+// A coluna que entra fica a cargo de quem chama; o datasheet pede pelo menos
+// dois quadros entre comandos seguidos.
+void ssd1306_scroll_content(bool left, uint8_t start_page, uint8_t end_page) {
+    uint8_t commands[] = {
+        ssd1306_set_content_scroll | (left ? 0x01 : 0x00), 0x00,
+        start_page & 0x07, 0x01, end_page & 0x07, 0x00, 0xFF
+    };
+
+    ssd1306_send_command_list(commands, count_of(commands));
+}
+
+// Linha da RAM exibida no topo da tela (0..63): rolagem vertical sem reenviar dados
+void ssd1306_set_start_line(uint8_t line) {
+    ssd1306_send_command(ssd1306_set_display_start_line | (line & 0x3F));
+}
+
 // Atualiza uma parte do display com uma área de renderização
 void render_on_display(uint8_t *ssd, struct render_area *area) {
     uint8_t commands[] = {
@@ -133,7 +154,7 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
 }
 
 // Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
+static inline int ssd1306_get_font(uint8_t character)
 {
   if (character >= 'A' && character <= 'Z') {
     return character - 'A' + 1;
@@ -141,6 +162,21 @@ inline int ssd1306_get_font(uint8_t character)
   else if (character >= '0' && character <= '9') {
     return character - '0' + 27;
   }
+  else if (character == '.') {
+    return 37;
+  }
+  else if (character == '-') {
+    return 38;
+  }
+  else if (character == ':') {
+    return 39;
+  }
+  else if (character == '%') {
+    return 40;
+  }
+  else if (character == '/') {
+    return 41;
+  }
   else
     return 0;
 }
@@ -162,6 +198,11 @@ void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
     }
 }
 
+// Uma coluna (0..7) do glifo de um caractere, para quem desenha coluna a coluna
+uint8_t ssd1306_glyph_column(uint8_t character, uint8_t column) {
+    return font[ssd1306_get_font(toupper(character)) * 8 + (column & 0x07)];
+}
+
 // Desenha uma string, chamando a função de desenhar caractere várias vezes
 void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
     if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
@@ -218,7 +259,12 @@ void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool externa
     ssd->address = address;
     ssd->i2c_port = i2c;
     ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+    if (ssd->bufsize > sizeof(bm_buffer)) {
+        ssd->bufsize = sizeof(bm_buffer);
+    }
+    // Um único display: o buffer é estático
+    ssd->ram_buffer = bm_buffer;
+    memset(bm_buffer, 0, sizeof(bm_buffer));
     ssd->ram_buffer[0] = 0x40;
     ssd->port_buffer[0] = 0x80;
 }
@@ -237,7 +283,7 @@ void ssd1306_send_data(ssd1306_t *ssd) {
 
 // Desenha o bitmap (a ser fornecido em display_oled.c) no display
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
+    for (size_t i = 0; i < ssd->bufsize - 1; i++) {
         ssd->ram_buffer[i + 1] = bitmap[i];
 
         ssd1306_send_data(ssd);
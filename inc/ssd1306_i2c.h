@@ -20,6 +20,7 @@
 #define ssd1306_set_column_address _u(0x21)
 #define ssd1306_set_page_address _u(0x22)
 #define ssd1306_set_horizontal_scroll _u(0x26)
+#define ssd1306_set_content_scroll _u(0x2C)
 #define ssd1306_set_scroll _u(0x2E)
 
 #define ssd1306_set_display_start_line _u(0x40)
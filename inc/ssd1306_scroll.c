@@ -0,0 +1,73 @@
+#include <string.h>
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "ssd1306_scroll.h"
+
+static void send_columns(uint8_t page, uint8_t start_column, uint8_t *data, uint8_t count) {
+    struct render_area area = {
+        .start_column = start_column,
+        .end_column   = start_column + count - 1,
+        .start_page   = page,
+        .end_page     = page
+    };
+    calculate_render_area_buffer_length(&area);
+    render_on_display(data, &area);
+}
+
+void ssd1306_ticker_start(ssd1306_ticker_t *t, uint8_t page, const char *text) {
+    snprintf(t->text, sizeof(t->text), "%s", text ? text : "");
+    size_t len = strlen(t->text);
+    t->page   = page & 0x07;
+    t->pos    = 0;
+    t->width  = (uint16_t)((len + 2) * 8); // dois espaços entre repetições
+    t->active = len > 0;
+
+    memset(t->shown, 0, sizeof(t->shown));
+    send_columns(t->page, 0, t->shown, ssd1306_width);
+}
+
+void ssd1306_ticker_step(ssd1306_ticker_t *t) {
+    if (!t->active) {
+        return;
+    }
+    ssd1306_scroll_content(true, t->page, t->page);
+
+    uint16_t ch = t->pos / 8;
+    uint8_t col = ch < strlen(t->text) ? ssd1306_glyph_column((uint8_t)t->text[ch], t->pos % 8) : 0;
+    memmove(t->shown, t->shown + 1, ssd1306_width - 1);
+    t->shown[ssd1306_width - 1] = col;
+    send_columns(t->page, ssd1306_width - 1, &t->shown[ssd1306_width - 1], 1);
+
+    t->pos = (uint16_t)((t->pos + 1) % t->width);
+}
+
+void ssd1306_pager_start(ssd1306_pager_t *p, const uint8_t *next_fb) {
+    p->next       = next_fb;
+    p->line       = 0;
+    p->pages_done = 0;
+    p->active     = true;
+}
+
+bool ssd1306_pager_step(ssd1306_pager_t *p, uint8_t lines) {
+    if (!p->active) {
+        return false;
+    }
+    uint16_t line = p->line + lines;
+    if (line > ssd1306_height) {
+        line = ssd1306_height;
+    }
+    // Com a linha inicial em L, as linhas 0..L-1 da RAM aparecem no fim da
+    // tela: a página k precisa ter o conteúdo novo antes de L passar de 8k
+    while (p->pages_done < ssd1306_n_pages && p->pages_done * 8 < line) {
+        uint8_t page = p->pages_done++;
+        send_columns(page, 0, (uint8_t *)&p->next[page * ssd1306_width], ssd1306_width);
+    }
+    p->line = (uint8_t)line;
+    ssd1306_set_start_line(p->line % ssd1306_height);
+
+    if (p->line >= ssd1306_height) {
+        p->active = false;
+    }
+    return p->active;
+}
@@ -0,0 +1,47 @@
+#ifndef SSD1306_SCROLL_H
+#define SSD1306_SCROLL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306_i2c.h"
+
+// =====================
+//  ROLAGEM POR HARDWARE
+// =====================
+// Letreiro: o controlador desloca a página uma coluna por passo
+// (ssd1306_scroll_content) e o MCU envia só a coluna que entra.
+// Paginação: a linha inicial da RAM avança e cada página que sai pelo
+// topo é reescrita com a próxima tela antes de reaparecer embaixo;
+// cada página da nova tela é enviada uma única vez.
+
+#define SSD1306_TICKER_MAX      64
+#define SSD1306_TICKER_STEP_MS  30  // >= 2 quadros entre deslocamentos
+#define SSD1306_PAGER_STEP_MS   16
+
+typedef struct {
+    char     text[SSD1306_TICKER_MAX + 1];
+    uint16_t width;   // largura do texto em pixels, incluindo o espaço final
+    uint16_t pos;     // próxima coluna do texto a entrar pela direita
+    uint8_t  page;
+    bool     active;
+    uint8_t  shown[ssd1306_width]; // cópia da página na tela (para quem lê o quadro)
+} ssd1306_ticker_t;
+
+typedef struct {
+    const uint8_t *next;  // framebuffer da próxima tela (ssd1306_buffer_length)
+    uint8_t line;         // linha inicial atual
+    uint8_t pages_done;   // páginas da próxima tela já enviadas
+    bool    active;
+} ssd1306_pager_t;
+
+// Limpa a página e começa a rolar "text" (vazio = só limpa e para)
+void ssd1306_ticker_start(ssd1306_ticker_t *t, uint8_t page, const char *text);
+// Um passo: desloca a página e envia a coluna nova
+void ssd1306_ticker_step(ssd1306_ticker_t *t);
+
+// Inicia a transição para a tela em "next_fb" (precisa continuar válido)
+void ssd1306_pager_start(ssd1306_pager_t *p, const uint8_t *next_fb);
+// Avança "lines" linhas; devolve false quando a transição terminou
+bool ssd1306_pager_step(ssd1306_pager_t *p, uint8_t lines);
+
+#endif
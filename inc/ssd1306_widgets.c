@@ -0,0 +1,343 @@
+#include <string.h>
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "ssd1306_widgets.h"
+
+typedef struct {
+    uint8_t kind;           // widget_kind_t
+    uint8_t x, page, width; // faixa ocupada (width em pixels)
+    bool    dirty;
+    union {
+        char text[WIDGET_TEXT_MAX + 1];
+        struct {
+            char     label[WIDGET_TEXT_MAX + 1];
+            char     unit[4];
+            int32_t  value;
+            uint8_t  decimals;
+            bool     valid;  // ainda sem valor: exibe "--"
+        } num;
+        struct {
+            int32_t  min, max;
+            uint8_t  filled; // colunas preenchidas (só muda se a barra mudar)
+        } bar;
+        struct {
+            const uint8_t *bitmap;
+            bool visible;
+        } icon;
+    } u;
+} widget_t;
+
+static widget_t widgets[WIDGETS_MAX];
+static uint     n_widgets;
+
+// Framebuffer persistente: espelho do que está na tela
+static uint8_t fb[ssd1306_buffer_length];
+
+// Colunas alteradas por página ainda não enviadas (lo > hi = limpa)
+static uint8_t dirty_lo[ssd1306_n_pages];
+static uint8_t dirty_hi[ssd1306_n_pages];
+
+static widgets_stats_t stats;
+
+static void mark_page(uint8_t page, uint8_t lo, uint8_t hi) {
+    if (dirty_lo[page] > dirty_hi[page]) {
+        dirty_lo[page] = lo;
+        dirty_hi[page] = hi;
+        return;
+    }
+    if (lo < dirty_lo[page]) dirty_lo[page] = lo;
+    if (hi > dirty_hi[page]) dirty_hi[page] = hi;
+}
+
+static void clear_page_marks(void) {
+    memset(dirty_lo, 0xFF, sizeof(dirty_lo));
+    memset(dirty_hi, 0x00, sizeof(dirty_hi));
+}
+
+void widgets_clear(void) {
+    n_widgets = 0;
+    memset(fb, 0, sizeof(fb));
+    for (uint p = 0; p < ssd1306_n_pages; p++) {
+        dirty_lo[p] = 0;
+        dirty_hi[p] = ssd1306_width - 1;
+    }
+}
+
+void widgets_init(void) {
+    memset(&stats, 0, sizeof(stats));
+    widgets_clear();
+}
+
+static int widget_new(widget_kind_t kind, uint8_t x, uint8_t page, uint8_t width) {
+    if (n_widgets >= WIDGETS_MAX || page >= ssd1306_n_pages || width == 0 ||
+        x >= ssd1306_width || width > ssd1306_width - x) {
+        return -1;
+    }
+    widget_t *w = &widgets[n_widgets];
+    memset(w, 0, sizeof(*w));
+    w->kind  = kind;
+    w->x     = x;
+    w->page  = page;
+    w->width = width;
+    w->dirty = true;
+    return n_widgets++;
+}
+
+static widget_t *widget_get(int id, widget_kind_t kind) {
+    if (id < 0 || (uint)id >= n_widgets || widgets[id].kind != kind) {
+        return NULL;
+    }
+    return &widgets[id];
+}
+
+int widget_add_text(uint8_t x, uint8_t page, uint8_t chars) {
+    if (chars > WIDGET_TEXT_MAX) {
+        chars = WIDGET_TEXT_MAX;
+    }
+    return widget_new(WIDGET_TEXT, x, page, chars * 8);
+}
+
+int widget_add_number(uint8_t x, uint8_t page, uint8_t chars, const char *label,
+                      uint8_t decimals, const char *unit) {
+    if (chars > WIDGET_TEXT_MAX) {
+        chars = WIDGET_TEXT_MAX;
+    }
+    int id = widget_new(WIDGET_NUMBER, x, page, chars * 8);
+    if (id >= 0) {
+        widget_t *w = &widgets[id];
+        snprintf(w->u.num.label, sizeof(w->u.num.label), "%s", label ? label : "");
+        snprintf(w->u.num.unit, sizeof(w->u.num.unit), "%s", unit ? unit : "");
+        w->u.num.decimals = decimals;
+    }
+    return id;
+}
+
+int widget_add_bar(uint8_t x, uint8_t page, uint8_t width, int32_t min, int32_t max) {
+    if (width < 3 || max <= min) {
+        return -1;
+    }
+    int id = widget_new(WIDGET_BAR, x, page, width);
+    if (id >= 0) {
+        widgets[id].u.bar.min = min;
+        widgets[id].u.bar.max = max;
+    }
+    return id;
+}
+
+int widget_add_icon(uint8_t x, uint8_t page, const uint8_t bitmap[8]) {
+    int id = widget_new(WIDGET_ICON, x, page, 8);
+    if (id >= 0) {
+        widgets[id].u.icon.bitmap = bitmap;
+    }
+    return id;
+}
+
+bool widget_set_text(int id, const char *text) {
+    widget_t *w = widget_get(id, WIDGET_TEXT);
+    if (!w || strncmp(w->u.text, text, WIDGET_TEXT_MAX) == 0) {
+        return false;
+    }
+    snprintf(w->u.text, sizeof(w->u.text), "%s", text);
+    w->dirty = true;
+    return true;
+}
+
+bool widget_set_number(int id, int32_t value) {
+    widget_t *w = widget_get(id, WIDGET_NUMBER);
+    if (!w || (w->u.num.valid && w->u.num.value == value)) {
+        return false;
+    }
+    w->u.num.value = value;
+    w->u.num.valid = true;
+    w->dirty = true;
+    return true;
+}
+
+bool widget_set_bar(int id, int32_t value) {
+    widget_t *w = widget_get(id, WIDGET_BAR);
+    if (!w) {
+        return false;
+    }
+    // Só o número de colunas preenchidas importa para a tela
+    int32_t span = w->u.bar.max - w->u.bar.min;
+    int32_t v = value < w->u.bar.min ? w->u.bar.min : (value > w->u.bar.max ? w->u.bar.max : value);
+    uint8_t filled = (uint8_t)((int64_t)(v - w->u.bar.min) * (w->width - 2) / span);
+    if (filled == w->u.bar.filled) {
+        return false;
+    }
+    w->u.bar.filled = filled;
+    w->dirty = true;
+    return true;
+}
+
+bool widget_set_icon(int id, bool visible) {
+    widget_t *w = widget_get(id, WIDGET_ICON);
+    if (!w || w->u.icon.visible == visible) {
+        return false;
+    }
+    w->u.icon.visible = visible;
+    w->dirty = true;
+    return true;
+}
+
+void widgets_invalidate(void) {
+    for (uint i = 0; i < n_widgets; i++) {
+        widgets[i].dirty = true;
+    }
+    for (uint p = 0; p < ssd1306_n_pages; p++) {
+        dirty_lo[p] = 0;
+        dirty_hi[p] = ssd1306_width - 1;
+    }
+}
+
+// Texto com espaços à direita até ocupar "chars" posições
+static void render_text(uint8_t *out, const char *text, uint8_t chars) {
+    for (uint i = 0; i < chars; i++) {
+        char c = *text ? *text++ : ' ';
+        ssd1306_draw_char(out, i * 8, 0, (uint8_t)c);
+    }
+}
+
+static void format_number(const widget_t *w, char *buf, size_t cap) {
+    if (!w->u.num.valid) {
+        snprintf(buf, cap, "%s --", w->u.num.label);
+        return;
+    }
+    int32_t v = w->u.num.value;
+    uint32_t a = v < 0 ? (uint32_t)-(int64_t)v : (uint32_t)v;
+    // 10^9 é a maior potência de 10 que cabe em uint32_t
+    int decimals = w->u.num.decimals < 9 ? w->u.num.decimals : 9;
+    uint32_t div = 1;
+    for (int i = 0; i < decimals; i++) {
+        div *= 10;
+    }
+    if (decimals) {
+        snprintf(buf, cap, "%s %s%lu.%0*lu%s", w->u.num.label, v < 0 ? "-" : "",
+                 (unsigned long)(a / div), decimals, (unsigned long)(a % div), w->u.num.unit);
+    } else {
+        snprintf(buf, cap, "%s %ld%s", w->u.num.label, (long)v, w->u.num.unit);
+    }
+}
+
+// Desenha o widget numa faixa de uma página (out[0..width-1])
+static void render_widget(const widget_t *w, uint8_t *out) {
+    char text[WIDGET_TEXT_MAX * 2];
+    switch (w->kind) {
+        case WIDGET_TEXT:
+            render_text(out, w->u.text, w->width / 8);
+            break;
+        case WIDGET_NUMBER:
+            format_number(w, text, sizeof(text));
+            render_text(out, text, w->width / 8);
+            break;
+        case WIDGET_BAR:
+            // Moldura nas pontas; interior preenchido até "filled"
+            out[0] = 0x7E;
+            for (uint i = 1; i + 1 < w->width; i++) {
+                out[i] = (i - 1 < w->u.bar.filled) ? 0x7E : 0x42;
+            }
+            out[w->width - 1] = 0x7E;
+            break;
+        case WIDGET_ICON:
+            for (uint i = 0; i < 8; i++) {
+                out[i] = w->u.icon.visible ? w->u.icon.bitmap[i] : 0;
+            }
+            break;
+    }
+}
+
+// Redesenha só os widgets sujos e registra as colunas que mudaram
+void widgets_render(void) {
+    stats.updates++;
+    for (uint i = 0; i < n_widgets; i++) {
+        widget_t *w = &widgets[i];
+        if (!w->dirty) {
+            continue;
+        }
+        uint8_t line[ssd1306_width];
+        memset(line, 0, sizeof(line));
+        render_widget(w, line);
+        stats.redraws++;
+
+        uint8_t *dst = &fb[w->page * ssd1306_width + w->x];
+        int lo = -1, hi = -1;
+        for (int c = 0; c < w->width; c++) {
+            if (dst[c] != line[c]) {
+                if (lo < 0) lo = c;
+                hi = c;
+            }
+        }
+        if (lo >= 0) {
+            memcpy(dst + lo, line + lo, hi - lo + 1);
+            mark_page(w->page, w->x + lo, w->x + hi);
+        }
+        w->dirty = false;
+    }
+}
+
+// Envia, página a página, a faixa de colunas alterada
+uint32_t widgets_flush(void) {
+    uint32_t sent = 0;
+    for (uint p = 0; p < ssd1306_n_pages; p++) {
+        if (dirty_lo[p] > dirty_hi[p]) {
+            continue;
+        }
+        struct render_area area = {
+            .start_column = dirty_lo[p],
+            .end_column   = dirty_hi[p],
+            .start_page   = p,
+            .end_page     = p
+        };
+        calculate_render_area_buffer_length(&area);
+        render_on_display(&fb[p * ssd1306_width + area.start_column], &area);
+        sent += area.buffer_length;
+        stats.flushes++;
+    }
+    clear_page_marks();
+    stats.bytes += sent;
+    return sent;
+}
+
+uint32_t widgets_update(void) {
+    widgets_render();
+    return widgets_flush();
+}
+
+const uint8_t *widgets_framebuffer(void) {
+    return fb;
+}
+
+void widgets_mark_flushed(void) {
+    clear_page_marks();
+}
+
+void widgets_blit(uint16_t offset, const uint8_t *src, uint16_t len) {
+    if (offset >= sizeof(fb)) {
+        return;
+    }
+    if (len > sizeof(fb) - offset) {
+        len = sizeof(fb) - offset;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        uint16_t idx = offset + i;
+        if (fb[idx] != src[i]) {
+            fb[idx] = src[i];
+            mark_page(idx / ssd1306_width, idx % ssd1306_width, idx % ssd1306_width);
+        }
+    }
+}
+
+void widgets_shadow(uint16_t offset, const uint8_t *src, uint16_t len) {
+    if (offset >= sizeof(fb)) {
+        return;
+    }
+    if (len > sizeof(fb) - offset) {
+        len = sizeof(fb) - offset;
+    }
+    memcpy(&fb[offset], src, len);
+}
+
+void widgets_get_stats(widgets_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,76 @@
+#ifndef SSD1306_WIDGETS_H
+#define SSD1306_WIDGETS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306_i2c.h"
+
+// =====================
+//  WIDGETS DO DISPLAY (modo retido)
+// =====================
+// Cada widget ocupa uma faixa de uma página (8 px de altura) e guarda o
+// último valor exibido. Mudar o valor só o marca como sujo; widgets_update()
+// redesenha os sujos no framebuffer persistente, compara com o conteúdo
+// anterior e envia por I2C apenas as colunas que mudaram em cada página.
+// Com os valores estáveis, widgets_update() não toca no barramento.
+
+#define WIDGETS_MAX       16
+#define WIDGET_TEXT_MAX   16  // caracteres (= largura do display)
+
+typedef enum {
+    WIDGET_TEXT = 0,
+    WIDGET_NUMBER,  // rótulo + valor em ponto fixo + unidade
+    WIDGET_BAR,     // barra horizontal proporcional
+    WIDGET_ICON,    // bitmap 8x8 (colunas, bit 0 = topo), visível ou não
+} widget_kind_t;
+
+typedef struct {
+    uint32_t updates;   // chamadas a widgets_render()
+    uint32_t redraws;   // widgets redesenhados
+    uint32_t flushes;   // escritas I2C de dados
+    uint32_t bytes;     // bytes de framebuffer enviados
+} widgets_stats_t;
+
+// Limpa o framebuffer e a tela; remove todos os widgets
+void widgets_init(void);
+// Como widgets_init(), mas mantém as estatísticas (troca de tela)
+void widgets_clear(void);
+
+// Criação: x em pixels, page = linha de texto (0..7), largura em
+// caracteres (texto/número) ou pixels (barra). Devolvem o id ou -1.
+int widget_add_text(uint8_t x, uint8_t page, uint8_t chars);
+int widget_add_number(uint8_t x, uint8_t page, uint8_t chars, const char *label,
+                      uint8_t decimals, const char *unit);
+int widget_add_bar(uint8_t x, uint8_t page, uint8_t width, int32_t min, int32_t max);
+int widget_add_icon(uint8_t x, uint8_t page, const uint8_t bitmap[8]);
+
+// Atualização do valor; devolvem true se o widget ficou sujo
+bool widget_set_text(int id, const char *text);
+bool widget_set_number(int id, int32_t value); // em 10^-decimals
+bool widget_set_bar(int id, int32_t value);
+bool widget_set_icon(int id, bool visible);
+
+// Força o redesenho de tudo (p.ex. depois de outra rotina usar a tela)
+void widgets_invalidate(void);
+
+// Redesenha os sujos e envia as regiões alteradas; devolve bytes enviados
+uint32_t widgets_update(void);
+
+// As duas metades de widgets_update(), para quem envia a tela de outro
+// jeito (p.ex. paginação por hardware): desenha no framebuffer, expõe o
+// framebuffer e descarta as marcas quando o conteúdo já foi enviado.
+void     widgets_render(void);
+uint32_t widgets_flush(void);
+const uint8_t *widgets_framebuffer(void);
+void     widgets_mark_flushed(void);
+
+// Copia bytes crus (formato de páginas do SSD1306) para o framebuffer a
+// partir de "offset"; marca só as colunas que mudaram
+void     widgets_blit(uint16_t offset, const uint8_t *src, uint16_t len);
+// Idem, sem marcar nada: o conteúdo já foi para a tela por outro caminho
+// (letreiro por hardware) e o framebuffer só acompanha
+void     widgets_shadow(uint16_t offset, const uint8_t *src, uint16_t len);
+
+void widgets_get_stats(widgets_stats_t *out);
+
+#endif
@@ -0,0 +1,294 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/netif.h"
+#include "lwip/dhcp.h"
+#include "flash_store.h"
+#include "log.h"
+#include "wifi_mgr.h"
+
+#ifndef CYW43_CHANNEL_NONE
+#define CYW43_CHANNEL_NONE 0xFFFFFFFFu
+#endif
+
+#define WIFI_UP_POLL_MS 500 // com IP basta notar a queda do enlace
+
+// Última associação bem-sucedida (FS_KEY_WIFI_CACHE)
+typedef struct {
+    uint32_t ssid_crc;  // o cache só vale para este SSID
+    uint8_t  bssid[6];
+    uint16_t reserved;
+    uint32_t channel;
+    uint32_t ip, netmask, gateway; // último lease do DHCP (0 = nenhum)
+} wifi_cache_t;
+
+static async_context_t *ctx;
+static async_at_time_worker_t worker;
+static void (*on_change)(wifi_state_t st);
+
+static char             ssid[33];
+static char             pass[FLASH_STORE_MAX_VALUE];
+static wifi_ip_config_t ip_cfg;
+
+static wifi_cache_t cache;
+static bool         cache_valid;
+
+static wifi_state_t state = WIFI_IDLE;
+static bool         fast;           // tentativa atual usa o cache
+static bool         addr_applied;   // IP fixo/lease do cache já aplicado
+static uint32_t     join_start_ms;
+static uint32_t     backoff_ms = WIFI_BACKOFF_MIN_MS;
+static uint32_t     up_ip;          // IP anunciado no último on_change
+static wifi_stats_t stats;
+
+static struct netif *sta_netif(void) {
+    return &cyw43_state.netif[CYW43_ITF_STA];
+}
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static uint32_t ssid_crc(void) {
+    return flash_store_crc32(0, ssid, strlen(ssid));
+}
+
+static void set_addr(uint32_t ip, uint32_t mask, uint32_t gw) {
+    ip4_addr_t a, m, g;
+    ip4_addr_set_u32(&a, ip);
+    ip4_addr_set_u32(&m, mask);
+    ip4_addr_set_u32(&g, gw);
+    netif_set_addr(sta_netif(), &a, &m, &g);
+}
+
+static void set_state(wifi_state_t st) {
+    state = st;
+    if (on_change) {
+        on_change(st);
+    }
+}
+
+static void schedule(uint32_t ms) {
+    async_context_add_at_time_worker_in_ms(ctx, &worker, ms);
+}
+
+// Canal atual da associação (WLC_GET_CHANNEL); sem o ioctl, varre tudo
+static uint32_t current_channel(void) {
+#ifdef CYW43_IOCTL_GET_CHANNEL
+    uint8_t buf[12] = {0}; // channel_info_t: hw_channel, target, scan
+    if (cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(buf), buf, CYW43_ITF_STA) == 0) {
+        uint32_t ch = buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+        if (ch >= 1 && ch <= 14) {
+            return ch;
+        }
+    }
+#endif
+    return CYW43_CHANNEL_NONE;
+}
+
+// Regrava o cache só quando algo mudou (poupa a flash)
+static void cache_store(const wifi_cache_t *c) {
+    if (cache_valid && memcmp(c, &cache, sizeof(cache)) == 0) {
+        return;
+    }
+    cache = *c;
+    cache_valid = true;
+    flash_store_set(FS_KEY_WIFI_CACHE, &cache, sizeof(cache));
+}
+
+static void cache_update_assoc(void) {
+    wifi_cache_t c = cache_valid ? cache : (wifi_cache_t){0};
+    if (cyw43_wifi_get_bssid(&cyw43_state, c.bssid) != 0) {
+        return;
+    }
+    if (c.ssid_crc != ssid_crc()) {
+        c.ip = c.netmask = c.gateway = 0; // lease de outra rede
+    }
+    c.ssid_crc = ssid_crc();
+    c.channel  = current_channel();
+    cache_store(&c);
+}
+
+static void cache_update_lease(void) {
+    struct netif *n = sta_netif();
+    if (!cache_valid || ip_cfg.ip || !dhcp_supplied_address(n)) {
+        return;
+    }
+    wifi_cache_t c = cache;
+    c.ip      = ip4_addr_get_u32(netif_ip4_addr(n));
+    c.netmask = ip4_addr_get_u32(netif_ip4_netmask(n));
+    c.gateway = ip4_addr_get_u32(netif_ip4_gw(n));
+    cache_store(&c);
+}
+
+// IP fixo: sem DHCP. DHCP: reinicia (pode ter sido parado por um IP fixo
+// anterior) e parte do zero até a associação.
+static void apply_ip_config(void) {
+    struct netif *n = sta_netif();
+    if (ip_cfg.ip) {
+        dhcp_stop(n);
+        set_addr(ip_cfg.ip, ip_cfg.netmask, ip_cfg.gateway);
+    } else if (!dhcp_supplied_address(n)) {
+        set_addr(0, 0, 0);
+        dhcp_start(n);
+    }
+}
+
+static void fail(int status);
+
+static void join(void) {
+    uint32_t auth = pass[0] ? CYW43_AUTH_WPA2_AES_PSK : CYW43_AUTH_OPEN;
+    stats.attempts++;
+    fast = cache_valid && cache.ssid_crc == ssid_crc();
+    addr_applied = false;
+    join_start_ms = now_ms();
+    apply_ip_config();
+
+    int rc;
+    if (fast) {
+        // Sem varredura: vai direto ao BSSID/canal da última vez
+        rc = cyw43_wifi_join(&cyw43_state, strlen(ssid), (const uint8_t *)ssid,
+                             strlen(pass), (const uint8_t *)pass, auth,
+                             cache.bssid, cache.channel);
+    } else {
+        rc = cyw43_arch_wifi_connect_async(ssid, pass[0] ? pass : NULL, auth);
+    }
+    LOG2(LOG_WIFI_JOIN, fast, rc);
+    if (rc != 0) {
+        fail(rc);
+        return;
+    }
+    set_state(WIFI_JOINING);
+    schedule(WIFI_POLL_MS);
+}
+
+static void fail(int status) {
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    if (fast) {
+        // BSSID/canal podem ter mudado: repete já, com varredura
+        LOG1(LOG_WIFI_FAST_FAIL, status);
+        cache_valid = false;
+        join();
+        return;
+    }
+    stats.failures++;
+    uint32_t wait = status == CYW43_LINK_BADAUTH ? WIFI_BACKOFF_MAX_MS : backoff_ms;
+    backoff_ms = MIN(wait * 2, WIFI_BACKOFF_MAX_MS);
+    LOG2(LOG_WIFI_FAIL, status, wait);
+    set_state(WIFI_BACKOFF);
+    schedule(wait);
+}
+
+static void poll_joining(void) {
+    struct netif *n = sta_netif();
+    int link = cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA);
+    uint32_t elapsed = now_ms() - join_start_ms;
+
+    if (link < 0 || elapsed > WIFI_JOIN_TIMEOUT_MS) {
+        fail(link < 0 ? link : CYW43_LINK_FAIL);
+        return;
+    }
+    if (link == CYW43_LINK_JOIN && !addr_applied) {
+        addr_applied = true;
+        cache_update_assoc();
+        if (ip_cfg.ip) {
+            // O driver pode religar o DHCP ao subir o enlace
+            dhcp_stop(n);
+            set_addr(ip_cfg.ip, ip_cfg.netmask, ip_cfg.gateway);
+        } else if (fast && cache.ip && !dhcp_supplied_address(n)) {
+            // Usa o último lease já; o DHCP confirma (ou troca) em seguida
+            set_addr(cache.ip, cache.netmask, cache.gateway);
+        }
+    }
+    if (link == CYW43_LINK_JOIN && ip4_addr_get_u32(netif_ip4_addr(n)) != 0) {
+        stats.last_join_ms = elapsed;
+        if (!stats.first_up_ms) {
+            stats.first_up_ms = now_ms();
+        }
+        stats.fast_joins += fast;
+        backoff_ms = WIFI_BACKOFF_MIN_MS;
+        up_ip = ip4_addr_get_u32(netif_ip4_addr(n));
+        LOG3(LOG_WIFI_UP, up_ip, elapsed, fast);
+        set_state(WIFI_UP);
+        schedule(WIFI_UP_POLL_MS);
+        return;
+    }
+    schedule(WIFI_POLL_MS);
+}
+
+static void poll_up(void) {
+    if (cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_JOIN) {
+        stats.link_losses++;
+        LOG(LOG_WIFI_LINK_LOST);
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+        join();
+        return;
+    }
+    cache_update_lease();
+    // O DHCP pode ter trocado o lease aplicado do cache
+    uint32_t ip = ip4_addr_get_u32(netif_ip4_addr(sta_netif()));
+    if (ip != up_ip && ip != 0) {
+        up_ip = ip;
+        set_state(WIFI_UP);
+    }
+    schedule(WIFI_UP_POLL_MS);
+}
+
+static void wifi_worker_fn(async_context_t *context, async_at_time_worker_t *w) {
+    switch (state) {
+        case WIFI_JOINING: poll_joining(); break;
+        case WIFI_UP:      poll_up();      break;
+        case WIFI_BACKOFF:
+        case WIFI_RECONFIG:
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            join();
+            break;
+        default: break;
+    }
+}
+
+static void copy_config(const char *s, const char *p, const wifi_ip_config_t *ip) {
+    strncpy(ssid, s, sizeof(ssid) - 1);
+    ssid[sizeof(ssid) - 1] = '\0';
+    strncpy(pass, p, sizeof(pass) - 1);
+    pass[sizeof(pass) - 1] = '\0';
+    ip_cfg = ip ? *ip : (wifi_ip_config_t){0};
+}
+
+void wifi_mgr_start(async_context_t *context, const char *s, const char *p,
+                    const wifi_ip_config_t *ip, void (*cb)(wifi_state_t st)) {
+    ctx = context;
+    on_change = cb;
+    worker.do_work = wifi_worker_fn;
+    copy_config(s, p, ip);
+    cache_valid = flash_store_get(FS_KEY_WIFI_CACHE, &cache, sizeof(cache)) == sizeof(cache);
+    join();
+}
+
+void wifi_mgr_reconfigure(const char *s, const char *p, const wifi_ip_config_t *ip) {
+    copy_config(s, p, ip);
+    async_context_remove_at_time_worker(ctx, &worker);
+    backoff_ms = WIFI_BACKOFF_MIN_MS;
+    fast = false;
+    if (state != WIFI_UP) {
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+        join();
+        return;
+    }
+    // Adiada: quem chama costuma ser um handler HTTP que ainda precisa
+    // entregar a resposta antes de o enlace cair
+    set_state(WIFI_RECONFIG);
+    schedule(WIFI_BACKOFF_MIN_MS);
+}
+
+wifi_state_t wifi_mgr_state(void) {
+    return state;
+}
+
+bool wifi_mgr_link_up(void) {
+    return state == WIFI_UP || state == WIFI_RECONFIG;
+}
+
+void wifi_mgr_get_stats(wifi_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,56 @@
+#ifndef WIFI_MGR_H
+#define WIFI_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/async_context.h"
+
+// =====================
+//  GERENCIADOR DE WI-FI
+// =====================
+// Conecta em segundo plano, num worker do async_context (nada bloqueia o
+// boot): o servidor HTTP já escuta enquanto a associação acontece.
+//   - caminho rápido: BSSID e canal da última conexão (sem varredura) e,
+//     sem IP fixo, o último lease aplicado na hora enquanto o DHCP confirma
+//   - IP fixo opcional (sem DHCP)
+//   - queda do enlace ou falha: nova tentativa com backoff exponencial
+// O cache fica na flash (FS_KEY_WIFI_CACHE) e só é regravado se mudar.
+
+#define WIFI_POLL_MS         100
+#define WIFI_JOIN_TIMEOUT_MS 10000
+#define WIFI_BACKOFF_MIN_MS  1000
+#define WIFI_BACKOFF_MAX_MS  60000
+
+typedef enum {
+    WIFI_IDLE = 0,
+    WIFI_JOINING,   // associação/DHCP em andamento
+    WIFI_UP,        // com IP
+    WIFI_BACKOFF,   // esperando para tentar de novo
+    WIFI_RECONFIG,  // nova configuração: ainda com IP, sai da rede em seguida
+} wifi_state_t;
+
+typedef struct {
+    uint32_t ip, netmask, gateway; // ordem de rede; ip = 0 usa DHCP
+} wifi_ip_config_t;
+
+typedef struct {
+    uint32_t attempts;
+    uint32_t failures;
+    uint32_t link_losses;
+    uint32_t fast_joins;        // conexões feitas pelo caminho rápido
+    uint32_t first_up_ms;       // boot -> primeiro IP (0 = ainda não)
+    uint32_t last_join_ms;      // duração da última conexão bem-sucedida
+} wifi_stats_t;
+
+// "on_change" roda no async_context a cada mudança de estado
+void wifi_mgr_start(async_context_t *ctx, const char *ssid, const char *pass,
+                    const wifi_ip_config_t *ip, void (*on_change)(wifi_state_t st));
+
+// Troca credenciais/IP e reconecta (cache descartado se o SSID mudar)
+void wifi_mgr_reconfigure(const char *ssid, const char *pass, const wifi_ip_config_t *ip);
+
+wifi_state_t wifi_mgr_state(void);
+bool         wifi_mgr_link_up(void); // com IP (WIFI_UP ou WIFI_RECONFIG)
+void         wifi_mgr_get_stats(wifi_stats_t *out);
+
+#endif
@@ -1,20 +1,36 @@
 #include "pico/cyw43_arch.h"
 #include "pico/stdlib.h"
+#include "pico/async_context.h"
 #include "lwip/tcp.h"
+#include "lwip/stats.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <malloc.h>
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#endif
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
-#include "ws2818b.pio.h"
+#include "hardware/watchdog.h"
 #include "inc/ssd1306_i2c.h"
 #include "inc/ssd1306.h"
-
-// Biblioteca NeoPixel
-#include "inc/neopixel.c"
+#include "inc/history.h"
+#include "inc/buttons.h"
+#include "inc/flash_store.h"
+#include "inc/flash_store_pico.h"
+#include "inc/app_state.h"
+#include "inc/presentation.h"
+#include "inc/rle.h"
+#include "inc/led_patterns.h"
+#include "inc/prof.h"
+#include "inc/log.h"
+#include "inc/wifi_mgr.h"
+#include "inc/assets.h"
+#include "inc/pool.h"
 
 // =====================
 //      DEFINIÇÕES
@@ -27,51 +43,202 @@ const uint I2C_SCL = 15;
 #define LED_PIN 12
 #define BUTTON1_PIN 5
 #define BUTTON2_PIN 6
+
+#define FETCH_INTERVAL_MS (HISTORY_SAMPLE_S * 1000)
+// Credenciais padrão; as gravadas via POST /api/wifi têm prioridade
 #define WIFI_SSID "AGUIA 2.4"
 #define WIFI_PASS "Leticia150789"
 
-// Mensagens
-char button1_message[50] = "Nenhum evento no botão 1";
-char button2_message[50] = "Nenhum evento no botão 2";
-char http_response[1024];
-
 // --- Variáveis para dados remotos (JSON) ---
 static float g_temperatura = 0.0f;
 static float g_umidade     = 0.0f;
 // Flag que indica se já estamos em processo de fetch
 static bool  g_fetch_in_progress = false;
+// Resultado do último fetch (o letreiro do display avisa quando muda)
+static bool  g_fetch_ok = true;
+// Requisições HTTP atendidas (exibido no painel do display)
+static uint32_t g_http_requests = 0;
+// Boot -> primeira requisição HTTP atendida (ms; 0 = nenhuma ainda)
+static uint32_t g_first_request_ms = 0;
+
+// --- Configuração persistida na flash ---
+static char g_wifi_ssid[33];
+static char g_wifi_pass[FLASH_STORE_MAX_VALUE];
+static wifi_ip_config_t g_wifi_ip; // ip = 0: DHCP
+static bool g_led_on = false;
+static int  g_led_brightness = 255; // brilho da matriz (0-255)
+// Tempo do dispositivo = base + uptime; a base é recuperada do histórico
+// salvo, para que os registros continuem em ordem após um reboot
+static uint32_t g_time_base_s = 0;
+
+// --- Loop de eventos ---
+// Núcleo 0: rede e lógica da aplicação rodam no async_context do cyw43
+// (IRQ de baixa prioridade, já com o lock do lwIP); fora delas o núcleo
+// escoa o log para o stdio e dorme em WFE.
+// Núcleo 1: display, NeoPixel e botões (inc/presentation.c).
+static void fetch_worker_fn(async_context_t *ctx, async_at_time_worker_t *worker);
+static void ui_event_worker_fn(async_context_t *ctx, async_when_pending_worker_t *worker);
+#if PROF_ENABLED
+static void lag_worker_fn(async_context_t *ctx, async_at_time_worker_t *worker);
+#endif
+static void log_drain_stdio(void);
+
+static async_at_time_worker_t      fetch_worker    = { .do_work = fetch_worker_fn };
+static async_when_pending_worker_t ui_event_worker = { .do_work = ui_event_worker_fn };
+
+#if PROF_ENABLED
+// Worker periódico só para medir o atraso do loop de eventos (/metrics)
+#define LAG_INTERVAL_MS 100
+static async_at_time_worker_t      lag_worker      = { .do_work = lag_worker_fn };
+static absolute_time_t             g_lag_due;
+#endif
+
+// Drena o log para o stdio (USB) aos poucos, no laço ocioso do main()
+// e fora do lock do lwIP: um host USB parado não trava a rede
+#define LOG_DRAIN_MS    50
+#define LOG_DRAIN_BATCH 8
+#define LOG_LINE_MAX    96
+static log_cursor_t                g_log_stdio;
+
+// Estado de cada conexão HTTP; respostas longas são geradas em blocos
+// à medida que o buffer de envio do TCP libera espaço.
+#define HTTP_REQ_MAX 1024 // cabeçalhos de navegador passam fácil de 512
+
+typedef struct http_conn {
+    struct tcp_pcb *pcb;
+    char     req[HTTP_REQ_MAX + 1]; // requisição acumulada (cabeçalho + corpo)
+    uint16_t req_len;
+    // Produtor do corpo: escreve até "cap" bytes e devolve 0 no fim
+    size_t (*fill)(struct http_conn *c, char *buf, size_t cap);
+    // Corpo constante (arquivos da flash): o lwIP referencia sem copiar
+    const uint8_t *body;
+    uint32_t body_left;
+    bool done;
+    bool sse;       // conexão /api/events mantida aberta
+    bool stream;    // corpo binário consumido em fluxo (POST /api/oled, /api/leds)
+    union {
+        struct {
+            history_cursor_t cursor;
+            bool binary;
+        } hist;
+        struct {
+            bool     leds;       // destino: matriz (true) ou OLED
+            bool     pbm;        // GET /api/oled.pbm
+            uint16_t offset;     // POST: posição inicial; GET: próxima linha/byte
+            uint32_t body_left;  // POST: bytes do corpo ainda por chegar
+            rle_decoder_t dec;
+            uint8_t  rgb[LED_COUNT][3];
+        } fb;
+        struct {
+            log_cursor_t cursor;
+            uint8_t      min_level;
+        } log;
+        struct {
+            uint32_t     line;   // próxima linha de /metrics
+            prof_stats_t snap;   // escopo em escrita (consistente entre blocos)
+        } metrics;
+    } u;
+} http_conn_t;
+
+#define HTTP_CHUNK_SIZE 256
+#define HTTP_MAX_CONNS  4   // MEMP_NUM_TCP_PCB (5) menos o pcb do fetch
+// Cada aba aberta prende uma conexão em /api/events: o limite fica abaixo
+// do pool para sobrar conexão para as demais requisições (excedente: 503)
+#define HTTP_MAX_SSE    2
+
+// Conexões e contextos de fetch vêm de pools estáticos (sem heap)
+POOL_DEFINE(g_http_pool, http_conn_t, HTTP_MAX_CONNS);
+
+// Contexto do cliente de /dados; um fetch por vez (g_fetch_in_progress)
+typedef struct {
+    struct tcp_pcb *pcb;
+    char buffer[512];
+    int  bufpos;
+} fetch_state_t;
+POOL_DEFINE(g_fetch_pool, fetch_state_t, 1);
+
+static http_conn_t *g_sse_conns[HTTP_MAX_SSE];
+// pcb abortado por http_close() durante o callback em andamento: o
+// callback precisa devolver ERR_ABRT ao lwIP
+static struct tcp_pcb *g_http_aborted;
+// Conexão que está montando um quadro do OLED (uma por vez)
+static http_conn_t *g_oled_writer;
 
 // ======================
 //   PROTÓTIPOS FUNÇÕES
 // ======================
 int main(void);
 
-// Display
+// Display (só na inicialização; depois o display é do núcleo 1)
 static void display_lines(const char *lines[], int count);
-static void display_ip_address(uint8_t ip0, uint8_t ip1, uint8_t ip2, uint8_t ip3);
+
+// Wi-Fi (inc/wifi_mgr.c)
+static void on_wifi_change(wifi_state_t st);
+static bool parse_ipv4(const char *s, uint32_t *out);
 
 // HTTP e Botões
-void create_http_response(void);
 static err_t http_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err);
+static err_t http_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len);
+static void  http_err_callback(void *arg, err_t err);
+static void  http_close(http_conn_t *c);
+static void  http_pump(http_conn_t *c);
+static void  http_handle_request(http_conn_t *c);
+static void  http_send_status(http_conn_t *c, const char *status, const char *body);
+static void  http_send_asset(http_conn_t *c, const asset_t *a);
+static void  http_send_state(http_conn_t *c);
+static bool  http_find_param(const char *p, const char *end, const char *name, char *out, size_t cap);
+static bool  http_query_param(const char *request, const char *name, char *out, size_t cap);
+static bool  http_start_history(http_conn_t *c, const char *request);
+static void  http_post_wifi(http_conn_t *c, const char *body);
+static void  http_start_sse(http_conn_t *c);
+static void  http_sse_remove(http_conn_t *c);
+static void  http_sse_broadcast(const char *msg, size_t len);
+static bool  http_stream_begin(http_conn_t *c, size_t content_length);
+static void  http_stream_data(http_conn_t *c, const uint8_t *data, size_t len);
+static void  http_stream_feed(http_conn_t *c, struct pbuf *p, uint16_t offset);
+static void  http_start_oled(http_conn_t *c, bool pbm);
+static void  http_send_leds(http_conn_t *c);
+static void  http_scene(http_conn_t *c, const char *params, const char *end);
+static void  http_send_patterns(http_conn_t *c);
+static void  http_send_pools(http_conn_t *c);
+static void  http_start_metrics(http_conn_t *c);
+static bool  http_start_log(http_conn_t *c, const char *request);
 static void start_http_server(void);
-void monitor_buttons(void);
+
+// Eventos de botão vindos do núcleo 1
+static void ui_event_notify(void);
+static void on_button_sse(const button_event_t *ev, void *ctx);
+static void on_button_action(const button_event_t *ev, void *ctx);
+static int  button_json(uint8_t button, char *buf, size_t cap);
 
 // Funções do “fetch” remoto
 bool fetch_remote_data(void); // inicia a conexão/GET
 static err_t fetch_connect_cb(void *arg, struct tcp_pcb *tpcb, err_t err);
 static err_t fetch_recv_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 static void  fetch_err_cb(void *arg, err_t err);
+static void  fetch_report(bool ok);
 
 // Função auxiliar para parse de JSON
 static bool parse_json(const char *json, float *temp_out, float *umi_out);
 
+// Persistência
+static void     load_settings(void);
+static void     set_led_state(bool on);
+static void     publish_net_state(void);
+static uint32_t device_time_s(void);
+static void     persist_rollup(const history_rollup_t *r);
+static bool     restore_rollup(const void *data, uint16_t len, void *ctx);
+
 // =====================
 //     FUNÇÃO  MAIN
 // =====================
 int main() {
-    // 1) Inicializa stdio / debug
+    // 1) Inicializa stdio / debug (a saída vem do log, drenado por um worker)
     stdio_init_all();
+    log_init();
+    log_cursor_oldest(&g_log_stdio);
 
     // 2) Inicializa I2C p/ display
     i2c_init(i2c1, ssd1306_i2c_clock * 1000);
@@ -102,70 +269,76 @@ int main() {
     };
     display_lines(inicializando, 3);
 
-    // 5) Inicializa Wi-Fi
+    // 5) Inicializa Wi-Fi; sem o chip não há o que servir: reinicia
     if (cyw43_arch_init()) {
         const char *erro_init[] = {
             " ERRO INICIAL  ",
             "    WIFI       "
         };
+        LOG(LOG_WIFI_INIT_FAIL);
         display_lines(erro_init, 2);
-        return 1;
+        watchdog_reboot(0, 0, 5000);
+        while (true) {
+            __wfe();
+        }
     }
     cyw43_arch_enable_sta_mode();
 
-    // 6) Conecta ao Wi-Fi
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK, 10000) != 0) {
-        const char *erro_conexao[] = {
-            " ERRO CONEXAO  ",
-            "    WIFI       "
-        };
-        display_lines(erro_conexao, 2);
-        return 1;
-    } else {
-        // Exibir IP caso conectado
-        uint8_t *ip_address = (uint8_t*)&(cyw43_state.netif[0].ip_addr.addr);
-        display_ip_address(ip_address[0], ip_address[1], ip_address[2], ip_address[3]);
-    }
+    async_context_t *ctx = cyw43_arch_async_context();
+    async_context_add_when_pending_worker(ctx, &ui_event_worker);
 
-    // 7) Inicializa NeoPixel
-    npInit(LED_PIN2, LED_COUNT);
-    npClear();
-    npWrite();
+    // 6) Lança o núcleo 1: display, NeoPixel e botões
+    static const uint button_pins[] = { BUTTON1_PIN, BUTTON2_PIN };
+    const pres_config_t pres = {
+        .led_pin      = LED_PIN2,
+        .led_count    = LED_COUNT,
+        .button_pins  = button_pins,
+        .button_count = count_of(button_pins),
+        .on_event     = ui_event_notify,
+    };
+    pres_start(&pres);
 
-    // 8) Configura LED e botões
-    gpio_init(LED_PIN);
-    gpio_set_dir(LED_PIN, GPIO_OUT);
+    // Daqui em diante a fila de comandos do núcleo 1 e o seqlock do
+    // app_state têm um único escritor: o async_context. O restante do
+    // boot roda com o lock dele, e os workers (botões, Wi-Fi) esperam.
+    cyw43_arch_lwip_begin();
 
-    gpio_init(BUTTON1_PIN);
-    gpio_set_dir(BUTTON1_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON1_PIN);
+    // Recupera configuração e histórico salvos na flash. A montagem pode
+    // gravar (formatação, coleta interrompida): só com o núcleo 1 no ar.
+    if (!flash_store_mount(flash_store_pico_dev())) {
+        LOG(LOG_FLASH_MOUNT_FAIL);
+    }
+    load_settings();
+    history_init();
+    pool_init(&g_http_pool);
+    pool_init(&g_fetch_pool);
+    flash_store_log_replay(FS_LOG_HISTORY, restore_rollup, NULL);
+    history_set_rollup_hook(persist_rollup);
 
-    gpio_init(BUTTON2_PIN);
-    gpio_set_dir(BUTTON2_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON2_PIN);
+    // 7) Configura LED
+    gpio_init(LED_PIN);
+    gpio_set_dir(LED_PIN, GPIO_OUT);
+    set_led_state(g_led_on);
 
-    // 9) Inicia servidor HTTP
+    // 8) Conecta ao Wi-Fi em segundo plano (o boot não espera) e já abre
+    // o servidor HTTP
+    wifi_mgr_start(ctx, g_wifi_ssid, g_wifi_pass, &g_wifi_ip, on_wifi_change);
     start_http_server();
 
-    // 10) Loop principal com atualização automática a cada 5 segundos
-    uint64_t last_fetch_ms = 0;
+    // 9) Agenda o fetch periódico
+    async_context_add_at_time_worker_in_ms(ctx, &fetch_worker, 0);
+#if PROF_ENABLED
+    g_lag_due = delayed_by_ms(get_absolute_time(), LAG_INTERVAL_MS);
+    async_context_add_at_time_worker_at(ctx, &lag_worker, g_lag_due);
+#endif
+    publish_net_state();
+    cyw43_arch_lwip_end();
 
+    // O trabalho acontece nas interrupções; aqui o núcleo só escoa o log
+    // e dorme (sleep_ms espera em WFE)
     while (true) {
-        cyw43_arch_poll();
-        monitor_buttons();
-
-        // Se já se passaram 5 segundos, inicia fetch
-        uint64_t now_ms = to_ms_since_boot(get_absolute_time());
-        if (!g_fetch_in_progress && (now_ms - last_fetch_ms >= 5000)) {
-            // Buscar dados se não estiver no meio de outro fetch
-            bool ok = fetch_remote_data();
-            if (ok) {
-                printf("Auto-fetch remoto...\n");
-            }
-            last_fetch_ms = now_ms;
-        }
-
-        sleep_ms(100);
+        log_drain_stdio();
+        sleep_ms(LOG_DRAIN_MS);
     }
 
     cyw43_arch_deinit();
@@ -175,162 +348,1216 @@ int main() {
 // ~~~~~~~~~~~~~~~~~~~~~
 //  Funções do DISPLAY
 // ~~~~~~~~~~~~~~~~~~~~~
+// Mensagens de inicialização: ficam na tela até o núcleo 1 assumir
 static void display_lines(const char *lines[], int count) {
-    struct render_area frame_area = {
-        .start_column = 0,
-        .end_column   = ssd1306_width - 1,
-        .start_page   = 0,
-        .end_page     = ssd1306_n_pages - 1
-    };
-    calculate_render_area_buffer_length(&frame_area);
-
-    uint8_t ssd[ssd1306_buffer_length];
-    memset(ssd, 0, sizeof(ssd));
+    pres_render_lines(lines, count);
+}
 
-    int y = 0;
-    for (int i = 0; i < count; i++) {
-        ssd1306_draw_string(ssd, 5, y, lines[i]);
-        y += 8;
+// ~~~~~~~~~~~~~~~~~~~~~
+//  Wi-Fi
+// ~~~~~~~~~~~~~~~~~~~~~
+// Chamado pelo gerenciador (inc/wifi_mgr.c) no async_context
+static void on_wifi_change(wifi_state_t st) {
+    static wifi_state_t prev = WIFI_IDLE;
+    char msg[PRES_TEXT_MAX + 1];
+    publish_net_state();
+    if (st == WIFI_UP) {
+        const uint8_t *ip = (const uint8_t *)&cyw43_state.netif[0].ip_addr.addr;
+        snprintf(msg, sizeof(msg), "CONECTADO %d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+        pres_set_ticker(msg);
+    } else if (st == WIFI_RECONFIG || (st == WIFI_JOINING && prev == WIFI_RECONFIG)) {
+        // Troca pedida pelo usuário: o handler já avisou no display
+    } else if (st == WIFI_JOINING && prev == WIFI_UP) {
+        pres_set_ticker("WIFI CAIU - RECONECTANDO");
+    } else if (st == WIFI_JOINING && prev == WIFI_IDLE) {
+        pres_set_ticker("CONECTANDO WIFI");
+    } else if (st == WIFI_BACKOFF && prev != WIFI_BACKOFF) {
+        pres_set_ticker("FALHA NO WIFI - TENTANDO DE NOVO");
     }
-    render_on_display(ssd, &frame_area);
-    sleep_ms(2000);
+    prev = st;
 }
 
-static void display_ip_address(uint8_t ip0, uint8_t ip1, uint8_t ip2, uint8_t ip3) {
-    char ip_str[20];
-    sprintf(ip_str, "%d.%d.%d.%d", ip0, ip1, ip2, ip3);
-
-    const char *ip_lines[] = {
-        " Conectado IP  ",
-        ip_str
-    };
-    display_lines(ip_lines, 2);
+// "a.b.c.d" -> IPv4 em ordem de rede
+static bool parse_ipv4(const char *s, uint32_t *out) {
+    uint32_t ip = 0;
+    for (int i = 0; i < 4; i++) {
+        if (!isdigit((unsigned char)*s)) {
+            return false;
+        }
+        char *next;
+        unsigned long b = strtoul(s, &next, 10);
+        if (b > 255 || next - s > 3 || *next != (i < 3 ? '.' : '\0')) {
+            return false;
+        }
+        ip |= (uint32_t)b << (8 * i);
+        s = next + (i < 3);
+    }
+    *out = ip;
+    return true;
 }
 
 // ~~~~~~~~~~~~~~~~~~~~~
 //  HTTP / Botões
 // ~~~~~~~~~~~~~~~~~~~~~
-void create_http_response(void) {
-    // Exibimos temperatura/umidade junto com os botões
-    snprintf(http_response, sizeof(http_response),
-             "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=UTF-8\r\n\r\n"
-             "<!DOCTYPE html>"
-             "<html>"
-             "<head>"
-             "<meta charset=\"UTF-8\">"
-             "<title>Controle do LED e Botões</title>"
-             "</head>"
-             "<body>"
-             "  <h1>Controle do LED e Botões</h1>"
-             "  <p><a href=\"/led/on\">Ligar LED</a></p>"
-             "  <p><a href=\"/led/off\">Desligar LED</a></p>"
-             "  <p><a href=\"/update\">Atualizar Dados Remotos</a></p>"
-             "  <h2>Estado dos Botões:</h2>"
-             "  <p>Botão 1: %s</p>"
-             "  <p>Botão 2: %s</p>"
-
-             "  <h2>Dados Remotos:</h2>"
-             "  <p>Temperatura: %.2f °C</p>"
-             "  <p>Umidade: %.2f %%</p>"
-
-             "</body>"
-             "</html>\r\n",
-             button1_message, button2_message,
-             g_temperatura, g_umidade);
+// Recepção medida como um todo (escopo http_callback)
+static err_t http_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    PROF_BEGIN(t0);
+    g_http_aborted = NULL;
+    err_t e = http_recv(arg, tpcb, p, err);
+    if (g_http_aborted == tpcb) {
+        e = ERR_ABRT;
+    }
+    PROF_END(PROF_HTTP_CALLBACK, t0);
+    return e;
 }
 
-static err_t http_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    http_conn_t *c = (http_conn_t *)arg;
     if (!p) {
-        tcp_close(tpcb);
+        http_close(c);
+        return ERR_OK;
+    }
+    tcp_recved(tpcb, p->tot_len);
+
+    // Corpo em fluxo: cada segmento vai direto para o decodificador
+    if (c->stream) {
+        http_stream_feed(c, p, 0);
+        pbuf_free(p);
+        return ERR_OK;
+    }
+
+    // Só a primeira requisição da conexão é atendida
+    if (c->done || c->fill) {
+        pbuf_free(p);
+        return ERR_OK;
+    }
+
+    // Acumula a requisição (pode chegar em vários segmentos)
+    uint16_t room = HTTP_REQ_MAX - c->req_len;
+    uint16_t n = pbuf_copy_partial(p, c->req + c->req_len, p->tot_len < room ? p->tot_len : room, 0);
+    bool overflow = p->tot_len > room;
+    c->req_len += n;
+    c->req[c->req_len] = '\0';
+
+    char *body = strstr(c->req, "\r\n\r\n");
+    if (!body) {
+        pbuf_free(p);
+        if (overflow) {
+            http_send_status(c, "431 Request Header Fields Too Large", NULL);
+        }
+        return ERR_OK;
+    }
+    body += 4;
+    const char *cl = strstr(c->req, "Content-Length:");
+    size_t content_length = (cl && cl < body) ? strtoul(cl + 15, NULL, 10) : 0;
+
+    // Quadros binários não passam por req[]: o que já chegou do corpo
+    // (em req[] e o resto deste segmento) segue para o decodificador
+    if (content_length > 0 && http_stream_begin(c, content_length)) {
+        uint16_t in_req = c->req_len - (body - c->req);
+        http_stream_data(c, (const uint8_t *)body, in_req);
+        http_stream_feed(c, p, n);
+        pbuf_free(p);
+        return ERR_OK;
+    }
+    pbuf_free(p);
+    if ((size_t)(c->req_len - (body - c->req)) < content_length) {
+        if (overflow || content_length > HTTP_REQ_MAX) {
+            http_send_status(c, "413 Payload Too Large", NULL);
+        }
         return ERR_OK;
     }
-    char *request = (char *)p->payload;
-
-    if (strstr(request, "GET /led/on")) {
-        gpio_put(LED_PIN, 1);
-        npClear();
-        // Exemplo: ligar alguns LEDs (verde)
-        npSetLED(2, 0, 255, 0);
-        npSetLED(6, 0, 255, 0);
-        npSetLED(8, 0, 255, 0);
-        npSetLED(10, 0, 255, 0);
-        npSetLED(11, 0, 255, 0);
-        npSetLED(14, 0, 255, 0);
-        npSetLED(15, 0, 255, 0);
-        npSetLED(17, 0, 255, 0);
-        npSetLED(19, 0, 255, 0);
-        npSetLED(22, 0, 255, 0);
-        npWrite();
-    }
-    else if (strstr(request, "GET /led/off")) {
-        gpio_put(LED_PIN, 0);
-        npClear();
-        npWrite();
-    }
-    else if (strstr(request, "GET /update")) {
+
+    http_handle_request(c);
+    return ERR_OK;
+}
+
+static void http_handle_request(http_conn_t *c) {
+    char *request = c->req;
+    char *body = strstr(request, "\r\n\r\n") + 4;
+
+    g_http_requests++;
+    if (!g_first_request_ms) {
+        g_first_request_ms = to_ms_since_boot(get_absolute_time());
+    }
+    publish_net_state();
+
+    if (strncmp(request, "GET /api/history", 16) == 0) {
+        if (!http_start_history(c, request)) {
+            http_send_status(c, "400 Bad Request", NULL);
+            return;
+        }
+        http_pump(c);
+        return;
+    }
+    if (strncmp(request, "POST /api/wifi", 14) == 0) {
+        http_post_wifi(c, body);
+        return;
+    }
+    if (strncmp(request, "GET /api/events", 15) == 0) {
+        http_start_sse(c);
+        return;
+    }
+    if (strncmp(request, "GET /api/oled.pbm", 17) == 0 || strncmp(request, "GET /api/oled.raw", 17) == 0) {
+        http_start_oled(c, request[14] == 'p');
+        http_pump(c);
+        return;
+    }
+    if (strncmp(request, "GET /api/leds", 13) == 0) {
+        http_send_leds(c);
+        return;
+    }
+    if (strncmp(request, "GET /api/scene", 14) == 0) {
+        const char *q = strchr(request, '?');
+        const char *end = strpbrk(request + 4, " \r\n");
+        if (q && end && q < end) {
+            http_scene(c, q + 1, end);
+        } else {
+            http_scene(c, end, end);
+        }
+        return;
+    }
+    if (strncmp(request, "POST /api/scene", 15) == 0) {
+        http_scene(c, body, body + strlen(body));
+        return;
+    }
+    if (strncmp(request, "GET /api/log", 12) == 0) {
+        if (!http_start_log(c, request)) {
+            http_send_status(c, "400 Bad Request", "level: debug|info|warn|error\n");
+            return;
+        }
+        http_pump(c);
+        return;
+    }
+    if (strncmp(request, "GET /metrics", 12) == 0) {
+        http_start_metrics(c);
+        http_pump(c);
+        return;
+    }
+    if (strncmp(request, "GET /api/pools", 14) == 0) {
+        http_send_pools(c);
+        return;
+    }
+    if (strncmp(request, "GET /api/patterns", 17) == 0) {
+        http_send_patterns(c);
+        return;
+    }
+    if (strncmp(request, "POST /api/oled", 14) == 0 || strncmp(request, "POST /api/leds", 14) == 0) {
+        // Com corpo, a requisição já foi tratada por http_stream_begin()
+        http_send_status(c, "400 Bad Request", "quadro ausente\n");
+        return;
+    }
+    if (strncmp(request, "GET /api/status", 15) == 0) {
+        http_send_state(c);
+        return;
+    }
+
+    // Ações dos links antigos: executam e voltam para o painel
+    bool action = true;
+    if (strncmp(request, "GET /led/on", 11) == 0) {
+        set_led_state(true);
+    }
+    else if (strncmp(request, "GET /led/off", 12) == 0) {
+        set_led_state(false);
+    }
+    else if (strncmp(request, "GET /update", 11) == 0) {
         // Inicia a busca de dados se não estiver em progresso
         if (!g_fetch_in_progress) {
             bool ok = fetch_remote_data();
             if (ok) {
-                printf("Fetch remoto via /update...\n");
+                LOG(LOG_FETCH_UPDATE);
             } else {
-                printf("Falha ao iniciar fetch.\n");
+                LOG(LOG_FETCH_START_FAIL);
             }
         }
     }
+    else {
+        action = false;
+    }
+    if (action) {
+        const char *hdr = "HTTP/1.1 303 See Other\r\nLocation: /\r\nConnection: close\r\n\r\n";
+        tcp_write(c->pcb, hdr, strlen(hdr), 0);
+        c->done = true;
+        http_pump(c);
+        return;
+    }
 
-    create_http_response();
-    tcp_write(tpcb, http_response, strlen(http_response), TCP_WRITE_FLAG_COPY);
-    pbuf_free(p);
-    return ERR_OK;
+    // Interface web (web/, comprimida na compilação)
+    const asset_t *a = NULL;
+    if (strncmp(request, "GET /", 5) == 0) {
+        a = asset_find(request + 4, strcspn(request + 4, " \r\n"));
+    }
+    if (a) {
+        http_send_asset(c, a);
+    } else {
+        http_send_status(c, "404 Not Found", NULL);
+    }
+}
+
+// Accept-Encoding aceita gzip? Sem o cabeçalho qualquer codificação
+// serve; "gzip;q=0" (ou "*;q=0") recusa
+static bool accepts_gzip(const char *req) {
+    const char *h = strstr(req, "\r\nAccept-Encoding:");
+    if (!h) {
+        return true;
+    }
+    const char *p = h + 18;
+    const char *eol = strstr(p, "\r\n");
+    if (!eol) {
+        eol = p + strlen(p);
+    }
+    while (p < eol) {
+        p += strspn(p, " \t,");
+        size_t len = strcspn(p, " \t,;\r");
+        if (len == 0 && *p != ';') {
+            break; // \r solto
+        }
+        bool match = (len == 4 && strncmp(p, "gzip", 4) == 0) || (len == 1 && *p == '*');
+        p += len;
+        p += strspn(p, " \t");
+        bool zero = false;
+        if (*p == ';') {
+            p += 1 + strspn(p + 1, " \t");
+            if (strncmp(p, "q=", 2) == 0) {
+                p += 2;
+                size_t q = strcspn(p, " \t,\r");
+                zero = q > 0 && strspn(p, "0.") == q;
+            }
+            p += strcspn(p, ",\r");
+        }
+        if (match) {
+            return !zero;
+        }
+    }
+    return false;
+}
+
+// Arquivo estático: só o cabeçalho é montado; o corpo gzip sai direto da
+// flash. Os referenciados com ?v=<hash> ficam no cache do navegador; o
+// HTML é revalidado pelo ETag (304 sem corpo).
+static void http_send_asset(http_conn_t *c, const asset_t *a) {
+    PROF_BEGIN(t0);
+    // Não há cópia descomprimida para servir
+    if (!accepts_gzip(c->req)) {
+        http_send_status(c, "406 Not Acceptable", "somente gzip\n");
+        PROF_END(PROF_HTTP_STATIC, t0);
+        return;
+    }
+    const char *inm = strstr(c->req, "\r\nIf-None-Match:");
+    const char *eol = inm ? strstr(inm + 2, "\r\n") : NULL;
+    const char *tag = inm ? strstr(inm, a->etag) : NULL;
+    bool not_modified = tag && (!eol || tag < eol);
+    const char *cache = a->immutable ? "public, max-age=31536000, immutable" : "no-cache";
+
+    char header[256];
+    int n;
+    if (not_modified) {
+        n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: %s\r\n"
+                     "Connection: close\r\n\r\n", a->etag, cache);
+    } else {
+        n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Encoding: gzip\r\n"
+                     "Content-Length: %lu\r\nETag: %s\r\nCache-Control: %s\r\n"
+                     "Vary: Accept-Encoding\r\nConnection: close\r\n\r\n",
+                     a->mime, (unsigned long)a->len, a->etag, cache);
+    }
+    if (n < 0 || n >= (int)sizeof(header)) {
+        // Cabeçalho truncado: ETag/MIME gerados longos demais
+        http_send_status(c, "500 Internal Server Error", NULL);
+        PROF_END(PROF_HTTP_STATIC, t0);
+        return;
+    }
+    if (!not_modified) {
+        c->body = a->data;
+        c->body_left = a->len;
+    }
+    tcp_write(c->pcb, header, n, TCP_WRITE_FLAG_COPY);
+    c->done = true;
+    http_pump(c);
+    PROF_END(PROF_HTTP_STATIC, t0);
+}
+
+// GET /api/status: instantâneo em JSON para o painel
+static void http_send_state(http_conn_t *c) {
+    static const char *const wifi_names[] = { "idle", "joining", "up", "backoff", "reconfig" };
+    net_state_t net;
+    app_state_read_net(&net);
+    const uint8_t *ip = (const uint8_t *)&net.ip;
+    char b1[96], b2[96];
+    button_json(0, b1, sizeof(b1));
+    button_json(1, b2, sizeof(b2));
+
+    char buf[384];
+    int n = snprintf(buf, sizeof(buf),
+                     "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-store\r\n"
+                     "Connection: close\r\n\r\n"
+                     "{\"temperatura\":%.2f,\"umidade\":%.2f,\"led\":%s,\"wifi\":\"%s\","
+                     "\"ip\":\"%d.%d.%d.%d\",\"requests\":%lu,\"uptime\":%lu,\"buttons\":[%s,%s]}\n",
+                     net.temperatura, net.umidade, net.led_on ? "true" : "false",
+                     wifi_names[wifi_mgr_state()], ip[0], ip[1], ip[2], ip[3],
+                     (unsigned long)net.http_requests,
+                     (unsigned long)(to_ms_since_boot(get_absolute_time()) / 1000), b1, b2);
+    tcp_write(c->pcb, buf, n < (int)sizeof(buf) ? n : (int)sizeof(buf) - 1, TCP_WRITE_FLAG_COPY);
+    c->done = true;
+    http_pump(c);
+}
+
+// Resposta curta em texto puro, encerrando a conexão
+static void http_send_status(http_conn_t *c, const char *status, const char *body) {
+    char buf[160];
+    int n = snprintf(buf, sizeof(buf),
+                     "HTTP/1.1 %s\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n%s",
+                     status, body ? body : "");
+    tcp_write(c->pcb, buf, n, TCP_WRITE_FLAG_COPY);
+    c->done = true;
+    http_pump(c);
 }
 
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    if (err != ERR_OK || !newpcb) {
+        return ERR_VAL;
+    }
+    http_conn_t *c = (http_conn_t *)pool_alloc(&g_http_pool);
+    if (!c) {
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+    c->pcb = newpcb;
+    tcp_arg(newpcb, c);
     tcp_recv(newpcb, http_callback);
+    tcp_sent(newpcb, http_sent_callback);
+    tcp_err(newpcb, http_err_callback);
     return ERR_OK;
 }
 
+static err_t http_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    g_http_aborted = NULL;
+    http_pump((http_conn_t *)arg);
+    return g_http_aborted == tpcb ? ERR_ABRT : ERR_OK;
+}
+
+static void http_err_callback(void *arg, err_t err) {
+    // O pcb já foi liberado pelo lwIP
+    http_sse_remove((http_conn_t *)arg);
+    if (g_oled_writer == arg) {
+        g_oled_writer = NULL;
+    }
+    pool_free(&g_http_pool, arg);
+}
+
+static void http_close(http_conn_t *c) {
+    if (!c) {
+        return;
+    }
+    http_sse_remove(c);
+    if (g_oled_writer == c) {
+        g_oled_writer = NULL;
+    }
+    tcp_arg(c->pcb, NULL);
+    tcp_recv(c->pcb, NULL);
+    tcp_sent(c->pcb, NULL);
+    tcp_err(c->pcb, NULL);
+    if (tcp_close(c->pcb) != ERR_OK) {
+        tcp_abort(c->pcb);
+        g_http_aborted = c->pcb;
+    }
+    pool_free(&g_http_pool, c);
+}
+
+// Gera o corpo em blocos enquanto houver espaço no buffer de envio,
+// sem nunca montar a resposta inteira em memória
+static void http_pump(http_conn_t *c) {
+    if (!c) {
+        return;
+    }
+    // Corpo constante: tcp_write sem cópia, limitado ao espaço de envio
+    while (c->body_left && tcp_sndqueuelen(c->pcb) < TCP_SND_QUEUELEN) {
+        u16_t n = c->body_left < tcp_sndbuf(c->pcb) ? c->body_left : tcp_sndbuf(c->pcb);
+        if (n == 0 || tcp_write(c->pcb, c->body, n, 0) != ERR_OK) {
+            break;
+        }
+        c->body += n;
+        c->body_left -= n;
+    }
+    char chunk[HTTP_CHUNK_SIZE];
+    while (c->fill && tcp_sndbuf(c->pcb) >= sizeof(chunk) && tcp_sndqueuelen(c->pcb) < TCP_SND_QUEUELEN) {
+        size_t n = c->fill(c, chunk, sizeof(chunk));
+        if (n == 0) {
+            c->fill = NULL;
+            c->done = true;
+            break;
+        }
+        if (tcp_write(c->pcb, chunk, n, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+            break;
+        }
+    }
+    tcp_output(c->pcb);
+
+    // Fecha só depois que tudo o que foi enfileirado for confirmado
+    if (c->done && c->body_left == 0 && tcp_sndqueuelen(c->pcb) == 0) {
+        http_close(c);
+    }
+}
+
+// Procura "name=valor" numa lista separada por '&' (query string ou corpo
+// de formulário) entre p e end, decodificando '+' e %XX
+static bool http_find_param(const char *p, const char *end, const char *name, char *out, size_t cap) {
+    size_t name_len = strlen(name);
+    while (p < end) {
+        const char *amp = memchr(p, '&', end - p);
+        const char *stop = amp ? amp : end;
+        if ((size_t)(stop - p) > name_len && strncmp(p, name, name_len) == 0 && p[name_len] == '=') {
+            size_t len = 0;
+            for (const char *v = p + name_len + 1; v < stop && len + 1 < cap; v++) {
+                if (*v == '+') {
+                    out[len++] = ' ';
+                } else if (*v == '%' && stop - v > 2 && isxdigit((unsigned char)v[1]) && isxdigit((unsigned char)v[2])) {
+                    char hex[3] = { v[1], v[2], '\0' };
+                    out[len++] = (char)strtoul(hex, NULL, 16);
+                    v += 2;
+                } else {
+                    out[len++] = *v;
+                }
+            }
+            out[len] = '\0';
+            return true;
+        }
+        p = stop + 1;
+    }
+    return false;
+}
+
+// Extrai o valor de "name" da query string da linha de requisição
+static bool http_query_param(const char *request, const char *name, char *out, size_t cap) {
+    const char *end = strpbrk(request, " \r\n");
+    end = end ? strpbrk(end + 1, " \r\n") : NULL; // fim do caminho
+    const char *q = strchr(request, '?');
+    if (!q || !end || q > end) {
+        return false;
+    }
+    return http_find_param(q + 1, end, name, out, cap);
+}
+
+static size_t http_fill_history(http_conn_t *c, char *buf, size_t cap) {
+    size_t pos = 0;
+    history_rollup_t r;
+    history_cursor_t *cur = &c->u.hist.cursor;
+    while (true) {
+        history_cursor_t save = *cur;
+        if (!history_next(cur, &r)) {
+            break;
+        }
+        size_t n = c->u.hist.binary
+                 ? history_format_bin(cur->res, &r, (uint8_t *)buf + pos, cap - pos)
+                 : history_format_csv(cur->res, &r, buf + pos, cap - pos);
+        if (n == 0) {
+            *cur = save; // não coube: fica para o próximo bloco
+            break;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+// GET /api/history?res=raw|1m|1h&from=<segundos desde o boot>&fmt=csv|bin
+static bool http_start_history(http_conn_t *c, const char *request) {
+    char res_str[8] = "";
+    char from_str[12] = "";
+    char fmt_str[8] = "";
+    http_query_param(request, "res", res_str, sizeof(res_str));
+    http_query_param(request, "from", from_str, sizeof(from_str));
+    http_query_param(request, "fmt", fmt_str, sizeof(fmt_str));
+
+    history_res_t res;
+    if (!history_parse_res(res_str, &res)) {
+        return false;
+    }
+    c->u.hist.binary = (strcmp(fmt_str, "bin") == 0);
+    history_cursor_init(&c->u.hist.cursor, res, (uint32_t)strtoul(from_str, NULL, 10));
+
+    char header[128];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nConnection: close\r\n\r\n%s",
+                     c->u.hist.binary ? "application/octet-stream" : "text/csv",
+                     c->u.hist.binary ? "" : history_csv_header(res));
+    tcp_write(c->pcb, header, n, TCP_WRITE_FLAG_COPY);
+    c->fill = http_fill_history;
+    return true;
+}
+// GET /api/events: Server-Sent Events com os gestos dos botões
+static void http_start_sse(http_conn_t *c) {
+    for (int i = 0; i < HTTP_MAX_SSE; i++) {
+        if (!g_sse_conns[i]) {
+            const char *hdr = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                              "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n";
+            g_sse_conns[i] = c;
+            c->sse = true;
+            tcp_write(c->pcb, hdr, strlen(hdr), 0);
+            tcp_output(c->pcb);
+            return;
+        }
+    }
+    http_send_status(c, "503 Service Unavailable", "Limite de clientes SSE\n");
+}
+
+static void http_sse_remove(http_conn_t *c) {
+    if (!c || !c->sse) {
+        return;
+    }
+    for (int i = 0; i < HTTP_MAX_SSE; i++) {
+        if (g_sse_conns[i] == c) {
+            g_sse_conns[i] = NULL;
+        }
+    }
+    c->sse = false;
+}
+
+// Envia a todos os clientes; quem estiver com o buffer cheio perde o evento
+static void http_sse_broadcast(const char *msg, size_t len) {
+    for (int i = 0; i < HTTP_MAX_SSE; i++) {
+        http_conn_t *c = g_sse_conns[i];
+        if (c && tcp_sndbuf(c->pcb) >= len && tcp_write(c->pcb, msg, len, TCP_WRITE_FLAG_COPY) == ERR_OK) {
+            tcp_output(c->pcb);
+        }
+    }
+}
+
+// POST /api/wifi com corpo "ssid=...&pass=...[&ip=...&mask=...&gw=...]"
+// (ssid vazio volta ao padrão; sem ip usa DHCP). Aplicado na hora: a
+// reconexão começa logo depois que a resposta sai.
+static void http_post_wifi(http_conn_t *c, const char *body) {
+    char ssid[sizeof(g_wifi_ssid)] = "";
+    char pass[sizeof(g_wifi_pass)] = "";
+    char val[16];
+    const char *end = body + strlen(body);
+    if (!http_find_param(body, end, "ssid", ssid, sizeof(ssid))) {
+        http_send_status(c, "400 Bad Request", "ssid ausente\n");
+        return;
+    }
+    http_find_param(body, end, "pass", pass, sizeof(pass));
+
+    wifi_ip_config_t ip = {0};
+    if (http_find_param(body, end, "ip", val, sizeof(val)) && val[0]) {
+        bool valid = parse_ipv4(val, &ip.ip) &&
+                     http_find_param(body, end, "gw", val, sizeof(val)) && parse_ipv4(val, &ip.gateway);
+        ip.netmask = 0x00FFFFFF; // 255.255.255.0 se "mask" faltar
+        if (valid && http_find_param(body, end, "mask", val, sizeof(val))) {
+            valid = parse_ipv4(val, &ip.netmask);
+        }
+        if (!valid || ip.ip == 0) {
+            http_send_status(c, "400 Bad Request", "ip/mask/gw invalidos\n");
+            return;
+        }
+    }
+
+    bool ok;
+    if (ssid[0] == '\0') {
+        ok = flash_store_del(FS_KEY_WIFI_SSID) && flash_store_del(FS_KEY_WIFI_PASS);
+    } else {
+        ok = flash_store_set(FS_KEY_WIFI_SSID, ssid, strlen(ssid) + 1) &&
+             flash_store_set(FS_KEY_WIFI_PASS, pass, strlen(pass) + 1);
+    }
+    ok = ok && (ip.ip ? flash_store_set(FS_KEY_WIFI_STATIC, &ip, sizeof(ip))
+                      : flash_store_del(FS_KEY_WIFI_STATIC));
+    if (ok) {
+        load_settings();
+        wifi_mgr_reconfigure(g_wifi_ssid, g_wifi_pass, &g_wifi_ip);
+        http_send_status(c, "200 OK", "Salvo. Reconectando.\n");
+        pres_set_ticker("WIFI SALVO - RECONECTANDO");
+    } else {
+        http_send_status(c, "500 Internal Server Error", "Falha ao gravar na flash\n");
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  FRAMEBUFFERS remotos (OLED e matriz)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// POST /api/oled?offset=<byte>&enc=raw|rle  corpo: bytes no formato de
+//      páginas do SSD1306 (página*128 + coluna), crus ou PackBits
+// POST /api/leds?first=<led>&enc=raw|rle   corpo: RGB de cada LED
+// O corpo é decodificado à medida que chega, direto na área de montagem
+// do núcleo 1; o quadro é aplicado inteiro quando o corpo termina.
+static bool http_stream_begin(http_conn_t *c, size_t content_length) {
+    bool leds = strncmp(c->req, "POST /api/leds", 14) == 0;
+    if (!leds && strncmp(c->req, "POST /api/oled", 14) != 0) {
+        return false;
+    }
+    g_http_requests++;
+    publish_net_state();
+
+    char val[12] = "";
+    http_query_param(c->req, "enc", val, sizeof(val));
+    bool rle = strcmp(val, "rle") == 0;
+    val[0] = '\0';
+    http_query_param(c->req, leds ? "first" : "offset", val, sizeof(val));
+    uint32_t offset = strtoul(val, NULL, 10);
+
+    if (leds) {
+        if (offset >= LED_COUNT) {
+            http_send_status(c, "400 Bad Request", "first fora da matriz\n");
+            return true;
+        }
+        rle_decoder_init(&c->u.fb.dec, &c->u.fb.rgb[0][0], (LED_COUNT - offset) * 3, !rle);
+    } else {
+        if (offset >= ssd1306_buffer_length) {
+            http_send_status(c, "400 Bad Request", "offset fora do display\n");
+            return true;
+        }
+        uint8_t *stage = g_oled_writer ? NULL : pres_oled_stage();
+        if (!stage) {
+            http_send_status(c, "503 Service Unavailable", "display ocupado\n");
+            return true;
+        }
+        g_oled_writer = c;
+        rle_decoder_init(&c->u.fb.dec, stage + offset, ssd1306_buffer_length - offset, !rle);
+    }
+    c->u.fb.leds = leds;
+    c->u.fb.offset = (uint16_t)offset;
+    c->u.fb.body_left = content_length;
+    c->stream = true;
+    return true;
+}
+
+static void http_stream_end(http_conn_t *c) {
+    char msg[48];
+    uint32_t len = c->u.fb.dec.pos;
+    bool ok;
+    if (c->u.fb.leds) {
+        ok = pres_patch_leds(c->u.fb.offset, (const uint8_t (*)[3])c->u.fb.rgb, len / 3);
+        snprintf(msg, sizeof(msg), "%lu LEDs\n", (unsigned long)(len / 3));
+    } else {
+        ok = pres_oled_commit(c->u.fb.offset, (uint16_t)len);
+        g_oled_writer = NULL;
+        snprintf(msg, sizeof(msg), "%lu bytes\n", (unsigned long)len);
+    }
+    if (ok) {
+        http_send_status(c, "200 OK", msg);
+    } else {
+        http_send_status(c, "503 Service Unavailable", "fila cheia\n");
+    }
+}
+
+static void http_stream_data(http_conn_t *c, const uint8_t *data, size_t len) {
+    if (!c->stream) {
+        return;
+    }
+    if (len > c->u.fb.body_left) {
+        len = c->u.fb.body_left;
+    }
+    c->u.fb.body_left -= len;
+    if (!rle_decode(&c->u.fb.dec, data, len)) {
+        c->stream = false;
+        if (g_oled_writer == c) {
+            g_oled_writer = NULL;
+        }
+        http_send_status(c, "413 Payload Too Large", "quadro maior que o destino\n");
+        return;
+    }
+    if (c->u.fb.body_left == 0) {
+        c->stream = false;
+        http_stream_end(c);
+    }
+}
+
+// Percorre a cadeia de pbufs sem copiar, a partir de "offset"
+static void http_stream_feed(http_conn_t *c, struct pbuf *p, uint16_t offset) {
+    for (struct pbuf *q = p; q && c->stream; q = q->next) {
+        if (offset >= q->len) {
+            offset -= q->len;
+            continue;
+        }
+        http_stream_data(c, (const uint8_t *)q->payload + offset, q->len - offset);
+        offset = 0;
+    }
+}
+
+// GET /api/oled.pbm: PBM binário (P4), pixel aceso = branco
+// GET /api/oled.raw: 1 KB no formato de páginas do SSD1306
+static size_t http_fill_oled(http_conn_t *c, char *buf, size_t cap) {
+    size_t n = 0;
+    if (!c->u.fb.pbm) {
+        uint16_t left = ssd1306_buffer_length - c->u.fb.offset;
+        n = cap < left ? cap : left;
+        pres_read_oled((uint8_t *)buf, c->u.fb.offset, n);
+        c->u.fb.offset += n;
+        return n;
+    }
+    // Cada linha PBM tem 16 bytes (bit 7 = pixel mais à esquerda)
+    uint8_t page[ssd1306_width];
+    int cached = -1;
+    while (c->u.fb.offset < ssd1306_height && cap - n >= ssd1306_width / 8) {
+        uint y = c->u.fb.offset++;
+        if ((int)(y / 8) != cached) {
+            cached = y / 8;
+            pres_read_oled(page, cached * ssd1306_width, ssd1306_width);
+        }
+        for (uint xb = 0; xb < ssd1306_width / 8; xb++) {
+            uint8_t bits = 0;
+            for (uint k = 0; k < 8; k++) {
+                if (!(page[xb * 8 + k] & (1u << (y % 8)))) {
+                    bits |= 0x80 >> k;
+                }
+            }
+            buf[n++] = bits;
+        }
+    }
+    return n;
+}
+
+static void http_start_oled(http_conn_t *c, bool pbm) {
+    const char *magic = "P4\n128 64\n";
+    char header[160];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: close\r\n\r\n%s",
+                     pbm ? "image/x-portable-bitmap" : "application/octet-stream",
+                     (unsigned)(ssd1306_buffer_length + (pbm ? strlen(magic) : 0)),
+                     pbm ? magic : "");
+    tcp_write(c->pcb, header, n, TCP_WRITE_FLAG_COPY);
+    c->u.fb.pbm = pbm;
+    c->u.fb.offset = 0;
+    c->fill = http_fill_oled;
+}
+
+// GET /api/leds: RGB de cada LED (3 bytes por LED)
+static void http_send_leds(http_conn_t *c) {
+    uint8_t rgb[LED_COUNT][3];
+    uint count = pres_read_leds(rgb, LED_COUNT);
+    char header[128];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                     count * 3);
+    tcp_write(c->pcb, header, n, TCP_WRITE_FLAG_COPY);
+    tcp_write(c->pcb, rgb, count * 3, TCP_WRITE_FLAG_COPY);
+    c->done = true;
+    http_pump(c);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  CENAS da matriz (várias alterações, uma escrita)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// GET /api/scene?pattern=<nome>&bright=<0-255>&px=<IIRRGGBB...>
+// POST /api/scene com os mesmos campos no corpo (formulário)
+// Sem "pattern" parte do quadro atual; "px" altera só os LEDs listados.
+// O quadro é montado aqui e vai ao núcleo 1 num único comando.
+static void http_scene(http_conn_t *c, const char *params, const char *end) {
+    uint8_t frame[LED_COUNT][3];
+    char name[16];
+    char val[8];
+    char px[LED_COUNT * 8 + 2];
+    bool changed = false;
+
+    if (http_find_param(params, end, "pattern", name, sizeof(name))) {
+        const led_pattern_t *pat = led_pattern_find(name);
+        if (!pat) {
+            http_send_status(c, "404 Not Found", "padrao desconhecido\n");
+            return;
+        }
+        led_pattern_render(pat, frame, LED_COUNT);
+        changed = true;
+    } else {
+        pres_read_leds(frame, LED_COUNT);
+    }
+
+    int brightness = -1;
+    if (http_find_param(params, end, "bright", val, sizeof(val))) {
+        char *stop;
+        long b = strtol(val, &stop, 10);
+        if (stop == val || *stop || b < 0 || b > 255) {
+            http_send_status(c, "400 Bad Request", "bright deve ser 0-255\n");
+            return;
+        }
+        brightness = (int)b;
+        changed = true;
+    }
+
+    if (http_find_param(params, end, "px", px, sizeof(px))) {
+        size_t len = strlen(px);
+        if (len > LED_COUNT * 8 || led_hex_apply(px, len, frame, LED_COUNT) < 0) {
+            http_send_status(c, "400 Bad Request", "px invalido (IIRRGGBB por LED)\n");
+            return;
+        }
+        changed = true;
+    }
+
+    if (!changed) {
+        http_send_status(c, "400 Bad Request", "informe pattern, bright ou px\n");
+        return;
+    }
+    if (!pres_set_scene((const uint8_t (*)[3])frame, LED_COUNT, brightness)) {
+        http_send_status(c, "503 Service Unavailable", "fila cheia\n");
+        return;
+    }
+    if (brightness >= 0) {
+        g_led_brightness = brightness;
+    }
+    char msg[32];
+    snprintf(msg, sizeof(msg), "brilho %d\n", g_led_brightness);
+    http_send_status(c, "200 OK", msg);
+}
+
+// GET /api/patterns: nomes aceitos em /api/scene, um por linha
+static void http_send_patterns(http_conn_t *c) {
+    char list[128];
+    size_t pos = 0;
+    const led_pattern_t *pat;
+    for (unsigned i = 0; (pat = led_pattern_get(i)) != NULL && pos < sizeof(list); i++) {
+        pos += snprintf(list + pos, sizeof(list) - pos, "%s\n", pat->name);
+    }
+    http_send_status(c, "200 OK", list);
+}
+
+// GET /api/pools: ocupação dos pools estáticos, um por linha
+// (nome em_uso/capacidade pico esgotamentos)
+static void http_send_pools(http_conn_t *c) {
+    char list[256];
+    size_t pos = 0;
+    const pool_t *p;
+    for (unsigned i = 0; (p = pool_get(i)) != NULL && pos < sizeof(list); i++) {
+        pos += snprintf(list + pos, sizeof(list) - pos, "%s %lu/%lu pico=%lu esgotado=%lu\n",
+                        p->name, (unsigned long)p->in_use, (unsigned long)p->capacity,
+                        (unsigned long)p->high_water, (unsigned long)p->exhausted);
+    }
+    char header[96];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n");
+    tcp_write(c->pcb, header, n, TCP_WRITE_FLAG_COPY);
+    tcp_write(c->pcb, list, pos < sizeof(list) ? pos : sizeof(list) - 1, TCP_WRITE_FLAG_COPY);
+    c->done = true;
+    http_pump(c);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  MÉTRICAS (GET /metrics, texto Prometheus)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// O corpo é gerado linha a linha pelo índice em c->u.metrics.line, em
+// quantos blocos o buffer de envio pedir. Cada escopo do histograma é
+// copiado uma vez (na primeira linha dele), para que baldes, soma e
+// contagem batam entre si.
+#define METRICS_LINE_MAX 128
+
+#if LWIP_STATS && MEMP_STATS
+static const struct {
+    memp_t      type;
+    const char *name;
+} lwip_memp_export[] = {
+    { MEMP_TCP_PCB,        "tcp_pcb" },
+    { MEMP_TCP_PCB_LISTEN, "tcp_pcb_listen" },
+    { MEMP_TCP_SEG,        "tcp_seg" },
+    { MEMP_UDP_PCB,        "udp_pcb" },
+    { MEMP_PBUF,           "pbuf" },
+    { MEMP_PBUF_POOL,      "pbuf_pool" },
+};
+#endif
+
+// Métricas simples: uma linha TYPE e uma de valor cada
+enum {
+    M_UPTIME = 0,
+    M_HTTP_REQUESTS,
+    M_HEAP_USED,
+    M_HEAP_ARENA,
+    M_BUTTON_DROPPED,
+    M_FIRST_REQUEST,
+    M_WIFI_UP,
+    M_WIFI_FIRST_UP,
+    M_WIFI_LAST_JOIN,
+    M_WIFI_ATTEMPTS,
+    M_WIFI_FAILURES,
+    M_WIFI_LINK_LOSSES,
+    M_WIFI_FAST_JOINS,
+#if LWIP_STATS && MEM_STATS
+    M_LWIP_MEM_USED,
+    M_LWIP_MEM_MAX,
+    M_LWIP_MEM_ERR,
+#endif
+    M_SIMPLE_COUNT
+};
+
+static int metrics_simple(uint32_t k, bool type, char *buf, size_t cap) {
+    static const struct { const char *name, *type; } info[M_SIMPLE_COUNT] = {
+        [M_UPTIME]         = { "bitdog_uptime_seconds",        "gauge" },
+        [M_HTTP_REQUESTS]  = { "bitdog_http_requests_total",   "counter" },
+        [M_HEAP_USED]      = { "bitdog_heap_used_bytes",       "gauge" },
+        [M_HEAP_ARENA]     = { "bitdog_heap_arena_bytes",      "gauge" }, // pico do heap (sbrk)
+        [M_BUTTON_DROPPED] = { "bitdog_button_events_dropped_total", "counter" },
+        [M_FIRST_REQUEST]  = { "bitdog_boot_to_first_request_milliseconds", "gauge" },
+        [M_WIFI_UP]        = { "bitdog_wifi_up",               "gauge" },
+        [M_WIFI_FIRST_UP]  = { "bitdog_wifi_boot_to_ip_milliseconds", "gauge" },
+        [M_WIFI_LAST_JOIN] = { "bitdog_wifi_last_connect_milliseconds", "gauge" },
+        [M_WIFI_ATTEMPTS]  = { "bitdog_wifi_join_attempts_total", "counter" },
+        [M_WIFI_FAILURES]  = { "bitdog_wifi_join_failures_total", "counter" },
+        [M_WIFI_LINK_LOSSES] = { "bitdog_wifi_link_losses_total", "counter" },
+        [M_WIFI_FAST_JOINS]  = { "bitdog_wifi_fast_joins_total", "counter" }, // pelo cache
+#if LWIP_STATS && MEM_STATS
+        [M_LWIP_MEM_USED]  = { "bitdog_lwip_mem_used_bytes",   "gauge" },
+        [M_LWIP_MEM_MAX]   = { "bitdog_lwip_mem_max_bytes",    "gauge" },
+        [M_LWIP_MEM_ERR]   = { "bitdog_lwip_mem_err_total",    "counter" },
+#endif
+    };
+    if (type) {
+        return snprintf(buf, cap, "# TYPE %s %s\n", info[k].name, info[k].type);
+    }
+    unsigned long v = 0;
+    wifi_stats_t ws;
+    wifi_mgr_get_stats(&ws);
+    switch (k) {
+        case M_UPTIME:         v = to_ms_since_boot(get_absolute_time()) / 1000; break;
+        case M_HTTP_REQUESTS:  v = g_http_requests; break;
+        case M_HEAP_USED:      v = mallinfo().uordblks; break;
+        case M_HEAP_ARENA:     v = mallinfo().arena; break;
+        case M_BUTTON_DROPPED: v = pres_events_dropped(); break;
+        case M_FIRST_REQUEST:  v = g_first_request_ms; break;
+        case M_WIFI_UP:        v = wifi_mgr_link_up(); break;
+        case M_WIFI_FIRST_UP:  v = ws.first_up_ms; break;
+        case M_WIFI_LAST_JOIN: v = ws.last_join_ms; break;
+        case M_WIFI_ATTEMPTS:  v = ws.attempts; break;
+        case M_WIFI_FAILURES:  v = ws.failures; break;
+        case M_WIFI_LINK_LOSSES: v = ws.link_losses; break;
+        case M_WIFI_FAST_JOINS:  v = ws.fast_joins; break;
+#if LWIP_STATS && MEM_STATS
+        case M_LWIP_MEM_USED:  v = lwip_stats.mem.used; break;
+        case M_LWIP_MEM_MAX:   v = lwip_stats.mem.max; break;
+        case M_LWIP_MEM_ERR:   v = lwip_stats.mem.err; break;
+#endif
+    }
+    return snprintf(buf, cap, "%s %lu\n", info[k].name, v);
+}
+
+static int metrics_seconds(char *buf, size_t cap, uint64_t us) {
+    return snprintf(buf, cap, "%lu.%06lu", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+}
+
+// Escreve a linha "i" em buf; devolve o tamanho ou -1 depois da última
+static int metrics_line(http_conn_t *c, uint32_t i, char *buf, size_t cap) {
+    const uint32_t per_scope = PROF_BUCKETS + 2; // baldes + _sum + _count
+
+    // Histograma de cada escopo
+    if (i == 0) {
+        return snprintf(buf, cap, "# TYPE bitdog_scope_seconds histogram\n");
+    }
+    i--;
+    if (i < PROF_SCOPE_COUNT * per_scope) {
+        prof_scope_id_t id = (prof_scope_id_t)(i / per_scope);
+        uint32_t k = i % per_scope;
+        prof_stats_t *st = &c->u.metrics.snap;
+        const char *name = prof_scope_name(id);
+        if (k == 0) {
+            prof_read(id, st);
+        }
+        if (k < PROF_BUCKETS) {
+            uint32_t cum = 0;
+            for (uint32_t b = 0; b <= k; b++) {
+                cum += st->hist[b];
+            }
+            char le[16] = "+Inf";
+            if (k < PROF_BUCKETS - 1) {
+                metrics_seconds(le, sizeof(le), prof_bucket_le_us[k]);
+            }
+            return snprintf(buf, cap, "bitdog_scope_seconds_bucket{scope=\"%s\",le=\"%s\"} %lu\n",
+                            name, le, (unsigned long)cum);
+        }
+        if (k == PROF_BUCKETS) {
+            int n = snprintf(buf, cap, "bitdog_scope_seconds_sum{scope=\"%s\"} ", name);
+            n += metrics_seconds(buf + n, cap - n, st->total_us);
+            return n + snprintf(buf + n, cap - n, "\n");
+        }
+        return snprintf(buf, cap, "bitdog_scope_seconds_count{scope=\"%s\"} %lu\n",
+                        name, (unsigned long)st->count);
+    }
+    i -= PROF_SCOPE_COUNT * per_scope;
+
+    // Pior caso de cada escopo desde o boot
+    if (i == 0) {
+        return snprintf(buf, cap, "# TYPE bitdog_scope_max_seconds gauge\n");
+    }
+    i--;
+    if (i < PROF_SCOPE_COUNT) {
+        prof_stats_t st;
+        prof_read((prof_scope_id_t)i, &st);
+        int n = snprintf(buf, cap, "bitdog_scope_max_seconds{scope=\"%s\"} ", prof_scope_name((prof_scope_id_t)i));
+        n += metrics_seconds(buf + n, cap - n, st.max_us);
+        return n + snprintf(buf + n, cap - n, "\n");
+    }
+    i -= PROF_SCOPE_COUNT;
+
+    // Pools estáticos (inc/pool.c)
+    static const struct { const char *name, *type; } pool_fam[] = {
+        { "bitdog_pool_in_use",          "gauge" },
+        { "bitdog_pool_capacity",        "gauge" },
+        { "bitdog_pool_high_water",      "gauge" },
+        { "bitdog_pool_exhausted_total", "counter" },
+    };
+    uint32_t n_pools = 0;
+    while (pool_get(n_pools)) {
+        n_pools++;
+    }
+    for (uint32_t f = 0; f < count_of(pool_fam); f++) {
+        if (i == 0) {
+            return snprintf(buf, cap, "# TYPE %s %s\n", pool_fam[f].name, pool_fam[f].type);
+        }
+        i--;
+        if (i < n_pools) {
+            const pool_t *p = pool_get(i);
+            const uint32_t v[] = { p->in_use, p->capacity, p->high_water, p->exhausted };
+            return snprintf(buf, cap, "%s{pool=\"%s\"} %lu\n", pool_fam[f].name, p->name, (unsigned long)v[f]);
+        }
+        i -= n_pools;
+    }
+
+    // Heap, lwIP mem e contadores gerais
+    if (i < 2 * M_SIMPLE_COUNT) {
+        return metrics_simple(i / 2, i % 2 == 0, buf, cap);
+    }
+    i -= 2 * M_SIMPLE_COUNT;
+
+#if LWIP_STATS && MEMP_STATS
+    // Pools internos do lwIP (pcbs, segmentos, pbufs)
+    static const struct { const char *name, *type; } memp_fam[] = {
+        { "bitdog_lwip_memp_used",      "gauge" },
+        { "bitdog_lwip_memp_max",       "gauge" },
+        { "bitdog_lwip_memp_err_total", "counter" },
+    };
+    const uint32_t n_memp = count_of(lwip_memp_export);
+    for (uint32_t f = 0; f < count_of(memp_fam); f++) {
+        if (i == 0) {
+            return snprintf(buf, cap, "# TYPE %s %s\n", memp_fam[f].name, memp_fam[f].type);
+        }
+        i--;
+        if (i < n_memp) {
+            const struct stats_mem *m = lwip_stats.memp[lwip_memp_export[i].type];
+            const unsigned long v[] = { m->used, m->max, m->err };
+            return snprintf(buf, cap, "%s{pool=\"%s\"} %lu\n", memp_fam[f].name, lwip_memp_export[i].name, v[f]);
+        }
+        i -= n_memp;
+    }
+#endif
+    return -1;
+}
+
+static size_t http_fill_metrics(http_conn_t *c, char *buf, size_t cap) {
+    char line[METRICS_LINE_MAX];
+    size_t pos = 0;
+    while (true) {
+        int n = metrics_line(c, c->u.metrics.line, line, sizeof(line));
+        if (n < 0) {
+            break;
+        }
+        if ((size_t)n >= sizeof(line)) {
+            n = sizeof(line) - 1;
+        }
+        if (pos + n > cap) {
+            break; // não coube: fica para o próximo bloco
+        }
+        memcpy(buf + pos, line, n);
+        pos += n;
+        c->u.metrics.line++;
+    }
+    return pos;
+}
+
+static void http_start_metrics(http_conn_t *c) {
+    const char *header = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n";
+    tcp_write(c->pcb, header, strlen(header), TCP_WRITE_FLAG_COPY);
+    c->u.metrics.line = 0;
+    c->fill = http_fill_metrics;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  LOG (GET /api/log?level=debug|info|warn|error)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Tudo o que ainda está nos anéis dos dois núcleos, do mais antigo ao
+// mais novo (inclusive do boot anterior), formatado só aqui
+static size_t http_fill_log(http_conn_t *c, char *buf, size_t cap) {
+    size_t pos = 0;
+    log_rec_t r;
+    while (true) {
+        log_cursor_t save = c->u.log.cursor;
+        if (!log_next(&c->u.log.cursor, &r)) {
+            break;
+        }
+        if (log_level(&r) < c->u.log.min_level) {
+            continue;
+        }
+        size_t n = log_format(&r, buf + pos, cap - pos);
+        if (n == 0) {
+            c->u.log.cursor = save; // não coube: fica para o próximo bloco
+            break;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+static bool http_start_log(http_conn_t *c, const char *request) {
+    char level_str[8] = "";
+    log_level_t level = LOG_DEBUG;
+    if (http_query_param(request, "level", level_str, sizeof(level_str)) &&
+        !log_parse_level(level_str, &level)) {
+        return false;
+    }
+    const char *header = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n";
+    tcp_write(c->pcb, header, strlen(header), TCP_WRITE_FLAG_COPY);
+    log_cursor_oldest(&c->u.log.cursor);
+    c->u.log.min_level = level;
+    c->fill = http_fill_log;
+    return true;
+}
+
 static void start_http_server(void) {
     struct tcp_pcb *pcb = tcp_new();
     if (!pcb) {
-        printf("Erro ao criar PCB\n");
+        LOG(LOG_HTTP_PCB_FAIL);
         return;
     }
     if (tcp_bind(pcb, IP_ADDR_ANY, 80) != ERR_OK) {
-        printf("Erro ao ligar o servidor na porta 80\n");
+        LOG1(LOG_HTTP_BIND_FAIL, 80);
         return;
     }
     pcb = tcp_listen(pcb);
     tcp_accept(pcb, connection_callback);
-    printf("Servidor HTTP rodando na porta 80...\n");
+    LOG1(LOG_HTTP_LISTENING, 80);
 }
 
-void monitor_buttons(void) {
-    static bool button1_last_state = false;
-    static bool button2_last_state = false;
+// {"pressed":..,"gesture":..,"ago_ms":..}; gesto null se ainda não houve
+static int button_json(uint8_t button, char *buf, size_t cap) {
+    ui_state_t ui;
+    app_state_read_ui(&ui);
+    const char *pressed = ui.pressed[button] ? "true" : "false";
+    if (!ui.seen[button]) {
+        return snprintf(buf, cap, "{\"pressed\":%s,\"gesture\":null}", pressed);
+    }
+    uint32_t ago_ms = (time_us_32() - ui.last[button].t_us) / 1000;
+    return snprintf(buf, cap, "{\"pressed\":%s,\"gesture\":\"%s\",\"ago_ms\":%lu}", pressed,
+                    buttons_gesture_name((button_gesture_t)ui.last[button].gesture), (unsigned long)ago_ms);
+}
 
-    bool button1_state = !gpio_get(BUTTON1_PIN);
-    bool button2_state = !gpio_get(BUTTON2_PIN);
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  ASSINANTES dos botões
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Chamado no núcleo 1 a cada evento enfileirado; set_work_pending pode
+// ser usado de outro núcleo e acorda o async_context do núcleo 0
+static void ui_event_notify(void) {
+    async_context_set_work_pending(cyw43_arch_async_context(), &ui_event_worker);
+}
 
-    if (button1_state != button1_last_state) {
-        button1_last_state = button1_state;
-        if (button1_state) {
-            snprintf(button1_message, sizeof(button1_message), "Botão 1 foi pressionado!");
-            printf("Botão 1 pressionado\n");
-        } else {
-            snprintf(button1_message, sizeof(button1_message), "Botão 1 foi solto!");
-            printf("Botão 1 solto\n");
-        }
-    }
+// Repassa os eventos aos clientes SSE de /api/events
+static void on_button_sse(const button_event_t *ev, void *ctx) {
+    char msg[96];
+    int n = snprintf(msg, sizeof(msg), "event: button\ndata: {\"button\":%u,\"gesture\":\"%s\",\"t_us\":%lu}\n\n",
+                     ev->button + 1, buttons_gesture_name((button_gesture_t)ev->gesture), (unsigned long)ev->t_us);
+    http_sse_broadcast(msg, n);
+}
 
-    if (button2_state != button2_last_state) {
-        button2_last_state = button2_state;
-        if (button2_state) {
-            snprintf(button2_message, sizeof(button2_message), "Botão 2 foi pressionado!");
-            printf("Botão 2 pressionado\n");
-        } else {
-            snprintf(button2_message, sizeof(button2_message), "Botão 2 foi solto!");
-            printf("Botão 2 solto\n");
+// Ações locais: botão 1 alterna o LED (pressão longa desliga);
+// botão 2 força uma atualização dos dados remotos
+static void on_button_action(const button_event_t *ev, void *ctx) {
+    if (ev->button == 0 && ev->gesture == BUTTON_CLICK) {
+        set_led_state(!g_led_on);
+    } else if (ev->button == 0 && ev->gesture == BUTTON_LONG_PRESS) {
+        set_led_state(false);
+    } else if (ev->button == 1 && ev->gesture == BUTTON_CLICK) {
+        if (!g_fetch_in_progress && fetch_remote_data()) {
+            LOG(LOG_FETCH_BUTTON);
         }
     }
 }
@@ -338,27 +1565,21 @@ void monitor_buttons(void) {
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //  CLIENTE lwIP p/ fetch /dados
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-typedef struct {
-    struct tcp_pcb *pcb;
-    char buffer[512];
-    int  bufpos;
-} fetch_state_t;
-
 bool fetch_remote_data(void) {
     if (g_fetch_in_progress) {
-        printf("Fetch já está em andamento.\n");
+        LOG(LOG_FETCH_BUSY);
         return false;
     }
-    fetch_state_t *fs = (fetch_state_t*)calloc(1, sizeof(fetch_state_t));
+    fetch_state_t *fs = (fetch_state_t*)pool_alloc(&g_fetch_pool);
     if (!fs) {
-        printf("Sem memória p/ fetch_state.\n");
+        LOG(LOG_FETCH_NO_SLOT);
         return false;
     }
 
     fs->pcb = tcp_new();
     if (!fs->pcb) {
-        printf("Erro ao criar pcb fetch.\n");
-        free(fs);
+        LOG(LOG_FETCH_PCB_FAIL);
+        pool_free(&g_fetch_pool, fs);
         return false;
     }
 
@@ -372,9 +1593,9 @@ bool fetch_remote_data(void) {
 
     err_t e = tcp_connect(fs->pcb, &remote_ip, 80, fetch_connect_cb);
     if (e != ERR_OK) {
-        printf("Erro tcp_connect: %d\n", e);
+        LOG1(LOG_FETCH_CONNECT_FAIL, e);
         tcp_close(fs->pcb);
-        free(fs);
+        pool_free(&g_fetch_pool, fs);
         return false;
     }
 
@@ -384,7 +1605,7 @@ bool fetch_remote_data(void) {
 
 static err_t fetch_connect_cb(void *arg, struct tcp_pcb *tpcb, err_t err) {
     if (err != ERR_OK) {
-        printf("Conexão fetch falhou.\n");
+        LOG1(LOG_FETCH_CONNECTED_FAIL, err);
         return err;
     }
 
@@ -393,7 +1614,7 @@ static err_t fetch_connect_cb(void *arg, struct tcp_pcb *tpcb, err_t err) {
     const char *req = "GET /dados HTTP/1.0\r\nHost: 192.168.15.24\r\n\r\n";
     err_t werr = tcp_write(tpcb, req, strlen(req), TCP_WRITE_FLAG_COPY);
     if (werr != ERR_OK) {
-        printf("Erro ao enviar GET: %d\n", werr);
+        LOG1(LOG_FETCH_SEND_FAIL, werr);
         return werr;
     }
     tcp_output(tpcb);
@@ -404,22 +1625,32 @@ static err_t fetch_connect_cb(void *arg, struct tcp_pcb *tpcb, err_t err) {
 static err_t fetch_recv_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
     fetch_state_t *fs = (fetch_state_t*)arg;
     if (!p) {
-        printf("Fim da resposta, parse do buffer...\n");
         char *json_start = strstr(fs->buffer, "{");
         if (json_start) {
             float t=0, u=0;
-            if (parse_json(json_start, &t, &u)) {
+            PROF_BEGIN(t_parse);
+            bool parsed = parse_json(json_start, &t, &u);
+            PROF_END(PROF_PARSE_JSON, t_parse);
+            if (parsed) {
                 g_temperatura = t;
                 g_umidade     = u;
-                printf("Dados ok: Temp=%.2f / Umid=%.2f\n", t, u);
+                history_add(device_time_s(), t, u);
+                publish_net_state();
+                fetch_report(true);
+                LOG2(LOG_FETCH_OK, log_f32(t), log_f32(u));
             } else {
-                printf("Falha parse JSON.\n");
+                LOG(LOG_FETCH_PARSE_FAIL);
+                fetch_report(false);
             }
         } else {
-            printf("Não encontrei '{' no buffer.\n");
+            LOG(LOG_FETCH_NO_JSON);
+            fetch_report(false);
         }
+        // Sem arg/err: um erro depois do close não devolve o contexto duas vezes
+        tcp_arg(fs->pcb, NULL);
+        tcp_err(fs->pcb, NULL);
         tcp_close(fs->pcb);
-        free(fs);
+        pool_free(&g_fetch_pool, fs);
         g_fetch_in_progress = false;
         return ERR_OK;
     }
@@ -438,14 +1669,19 @@ static err_t fetch_recv_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_
 
 static void fetch_err_cb(void *arg, err_t err) {
     fetch_state_t *fs = (fetch_state_t*)arg;
-    printf("fetch_err_cb: erro=%d\n", err);
-    if (fs) {
-        if (fs->pcb) {
-            tcp_close(fs->pcb);
-        }
-        free(fs);
-    }
+    LOG1(LOG_FETCH_ERR, err);
+    // O pcb já foi liberado pelo lwIP
+    pool_free(&g_fetch_pool, fs);
     g_fetch_in_progress = false;
+    fetch_report(false);
+}
+
+static void fetch_report(bool ok) {
+    if (ok == g_fetch_ok) {
+        return;
+    }
+    g_fetch_ok = ok;
+    pres_set_ticker(ok ? "DADOS REMOTOS OK" : "FALHA AO BUSCAR DADOS REMOTOS");
 }
 
 static bool parse_json(const char *json, float *temp_out, float *umi_out) {
@@ -473,3 +1709,130 @@ static bool parse_json(const char *json, float *temp_out, float *umi_out) {
     *umi_out  = u;
     return true;
 }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  PERSISTÊNCIA (flash)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static void load_settings(void) {
+    if (flash_store_get(FS_KEY_WIFI_SSID, g_wifi_ssid, sizeof(g_wifi_ssid)) <= 0 ||
+        flash_store_get(FS_KEY_WIFI_PASS, g_wifi_pass, sizeof(g_wifi_pass)) < 0) {
+        snprintf(g_wifi_ssid, sizeof(g_wifi_ssid), "%s", WIFI_SSID);
+        snprintf(g_wifi_pass, sizeof(g_wifi_pass), "%s", WIFI_PASS);
+    }
+    g_wifi_ssid[sizeof(g_wifi_ssid) - 1] = '\0';
+    g_wifi_pass[sizeof(g_wifi_pass) - 1] = '\0';
+    if (flash_store_get(FS_KEY_WIFI_STATIC, &g_wifi_ip, sizeof(g_wifi_ip)) != sizeof(g_wifi_ip)) {
+        memset(&g_wifi_ip, 0, sizeof(g_wifi_ip));
+    }
+
+    uint8_t led = 0;
+    if (flash_store_get(FS_KEY_LED_STATE, &led, sizeof(led)) == sizeof(led)) {
+        g_led_on = led != 0;
+    }
+}
+
+static void set_led_state(bool on) {
+    gpio_put(LED_PIN, on);
+    uint8_t frame[LED_COUNT][3];
+    led_pattern_render(led_pattern_find(on ? "padrao" : "apagado"), frame, LED_COUNT);
+    // O envio para a fita acontece no núcleo 1
+    pres_set_leds((const uint8_t (*)[3])frame, LED_COUNT);
+
+    if (on != g_led_on) {
+        uint8_t led = on;
+        g_led_on = on;
+        flash_store_set(FS_KEY_LED_STATE, &led, sizeof(led));
+        publish_net_state();
+    }
+}
+
+// Publica o estado do núcleo 0 para o núcleo 1 (tela) e acorda-o
+static void publish_net_state(void) {
+    net_state_t net = {
+        .temperatura   = g_temperatura,
+        .umidade       = g_umidade,
+        .ip            = wifi_mgr_link_up() ? cyw43_state.netif[0].ip_addr.addr : 0,
+        .led_on        = g_led_on,
+        .http_requests = g_http_requests,
+    };
+    app_state_publish_net(&net);
+    pres_wake();
+}
+
+static uint32_t device_time_s(void) {
+    return g_time_base_s + to_ms_since_boot(get_absolute_time()) / 1000;
+}
+
+// Só os agregados de 1 minuto vão para a flash (~24 bytes/min); o
+// armazenamento agrupa os registros e grava uma página por vez.
+static void persist_rollup(const history_rollup_t *r) {
+    flash_store_append(FS_LOG_HISTORY, r, sizeof(*r));
+}
+
+static bool restore_rollup(const void *data, uint16_t len, void *ctx) {
+    if (len != sizeof(history_rollup_t)) {
+        return true;
+    }
+    history_rollup_t r;
+    memcpy(&r, data, sizeof(r));
+    history_restore(&r);
+    // Retoma o relógio logo após o último minuto salvo
+    g_time_base_s = r.t + 60;
+    return true;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  LOG no stdio (laço do main)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Formata poucos registros por vez; sem host no USB o cursor fica parado
+// e, ao conectar, o que ainda estiver no anel (até do boot anterior) sai.
+// Roda sem o lock do async_context: log_next só lê os anéis.
+static void log_drain_stdio(void) {
+#if LIB_PICO_STDIO_USB
+    bool drain = stdio_usb_connected();
+#else
+    bool drain = true;
+#endif
+    if (drain) {
+        char line[LOG_LINE_MAX];
+        log_rec_t r;
+        for (int i = 0; i < LOG_DRAIN_BATCH && log_next(&g_log_stdio, &r); i++) {
+            size_t n = log_format(&r, line, sizeof(line));
+            if (n) {
+                fwrite(line, 1, n, stdout);
+            }
+        }
+        fflush(stdout);
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//  WORKERS do loop de eventos
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static void fetch_worker_fn(async_context_t *ctx, async_at_time_worker_t *worker) {
+    // Buscar dados se houver rede e não estiver no meio de outro fetch
+    if (wifi_mgr_state() == WIFI_UP && !g_fetch_in_progress && fetch_remote_data()) {
+        LOG(LOG_FETCH_AUTO);
+    }
+    async_context_add_at_time_worker_in_ms(ctx, worker, FETCH_INTERVAL_MS);
+}
+
+#if PROF_ENABLED
+// Atraso entre o instante agendado e a execução: mede o quanto os
+// callbacks do lwIP e os demais workers seguram o núcleo 0
+static void lag_worker_fn(async_context_t *ctx, async_at_time_worker_t *worker) {
+    absolute_time_t now = get_absolute_time();
+    PROF_RECORD(PROF_CORE0_LAG, (uint32_t)absolute_time_diff_us(g_lag_due, now));
+    g_lag_due = delayed_by_ms(now, LAG_INTERVAL_MS);
+    async_context_add_at_time_worker_at(ctx, worker, g_lag_due);
+}
+#endif
+
+// Consome os eventos de botão repassados pelo núcleo 1
+static void ui_event_worker_fn(async_context_t *ctx, async_when_pending_worker_t *worker) {
+    button_event_t ev;
+    while (pres_pop_event(&ev)) {
+        on_button_sse(&ev, NULL);
+        on_button_action(&ev, NULL);
+    }
+}
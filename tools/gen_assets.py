@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Gera a tabela de arquivos estáticos da interface web.
+
+Uso: gen_assets.py <dir_web> <saida.c>
+
+Cada arquivo de <dir_web> é comprimido com gzip (nível 9, sem data no
+cabeçalho, para a saída ser reprodutível) e vira um vetor const (fica na
+flash). O ETag é um hash do conteúdo descomprimido.
+
+Nos .html, "{{arquivo}}" é trocado pelo hash desse arquivo: as referências
+ficam como "app.js?v=<hash>" e os arquivos referenciados podem ser
+servidos com cache longo (immutable). Os .html são sempre revalidados.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+MIME = {
+    ".html": "text/html; charset=utf-8",
+    ".css":  "text/css; charset=utf-8",
+    ".js":   "application/javascript; charset=utf-8",
+    ".svg":  "image/svg+xml",
+    ".png":  "image/png",
+    ".ico":  "image/x-icon",
+    ".json": "application/json",
+}
+
+PLACEHOLDER = re.compile(rb"\{\{([A-Za-z0-9_.\-]+)\}\}")
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def c_bytes(data, indent="    ", per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        chunk = data[i:i + per_line]
+        lines.append(indent + ", ".join("0x%02x" % b for b in chunk) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("uso: gen_assets.py <dir_web> <saida.c>")
+    web_dir, out_path = sys.argv[1], sys.argv[2]
+
+    names = sorted(n for n in os.listdir(web_dir)
+                   if os.path.isfile(os.path.join(web_dir, n)) and not n.startswith("."))
+    raw = {}
+    for name in names:
+        ext = os.path.splitext(name)[1].lower()
+        if ext not in MIME:
+            sys.exit("gen_assets: tipo desconhecido: " + name)
+        with open(os.path.join(web_dir, name), "rb") as f:
+            raw[name] = f.read()
+
+    # Hashes dos arquivos referenciados primeiro; depois os .html
+    hashes = {n: content_hash(d) for n, d in raw.items() if not n.endswith(".html")}
+
+    def substitute(m):
+        ref = m.group(1).decode()
+        if ref not in hashes:
+            sys.exit("gen_assets: referencia desconhecida: {{%s}}" % ref)
+        return hashes[ref].encode()
+
+    for name in names:
+        if name.endswith(".html"):
+            raw[name] = PLACEHOLDER.sub(substitute, raw[name])
+            hashes[name] = content_hash(raw[name])
+
+    # Índice ordenado pelo caminho (busca binária no firmware)
+    entries = sorted(("/" + n, n) for n in names)
+
+    out = []
+    out.append("// Gerado por tools/gen_assets.py a partir de web/ (não editar)")
+    out.append('#include "inc/assets.h"')
+    out.append("")
+    total_raw = total_gz = 0
+    for i, (path, name) in enumerate(entries):
+        gz = gzip.compress(raw[name], compresslevel=9, mtime=0)
+        total_raw += len(raw[name])
+        total_gz += len(gz)
+        out.append("// %s: %u -> %u bytes" % (path, len(raw[name]), len(gz)))
+        out.append("static const uint8_t asset_%u[] __attribute__((aligned(4))) = {" % i)
+        out.append(c_bytes(gz))
+        out.append("};")
+        out.append("")
+
+    out.append("const asset_t g_assets[] = {")
+    for i, (path, name) in enumerate(entries):
+        ext = os.path.splitext(name)[1].lower()
+        out.append('    { "%s", "%s", asset_%u, sizeof(asset_%u), %u, "\\"%s\\"", %s },' % (
+            path, MIME[ext], i, i, len(raw[name]), hashes[name],
+            "false" if ext == ".html" else "true"))
+    out.append("};")
+    out.append("const unsigned g_assets_count = %u;" % len(entries))
+    out.append("")
+
+    with open(out_path, "w", newline="\n") as f:
+        f.write("\n".join(out))
+    print("gen_assets: %u arquivos, %u -> %u bytes" % (len(entries), total_raw, total_gz))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,93 @@
+// Painel do BitDogLab: estado por /api/status, botões por SSE
+// (/api/events) e histórico em CSV (/api/history)
+'use strict';
+
+const $ = (id) => document.getElementById(id);
+const STATUS_MS = 5000;
+const HISTORY_MS = 60000;
+
+// As rotas antigas respondem com redirecionamento para "/": não seguir
+const action = (url) => fetch(url, { redirect: 'manual' }).then(refresh);
+
+async function refresh() {
+  try {
+    const s = await (await fetch('/api/status', { cache: 'no-store' })).json();
+    $('temp').textContent = s.temperatura.toFixed(2);
+    $('umid').textContent = s.umidade.toFixed(2);
+    $('led').checked = s.led;
+    $('net').textContent = s.wifi === 'up' ? s.ip : 'sem wifi';
+    $('net').classList.toggle('ok', s.wifi === 'up');
+    s.buttons.forEach((b, i) => {
+      document.querySelector(`[data-b="${i + 1}"]`).textContent =
+        (b.pressed ? 'pressionado' : 'solto') + (b.gesture ? ` (último: ${b.gesture})` : '');
+    });
+  } catch (e) {
+    $('net').textContent = 'offline';
+    $('net').classList.remove('ok');
+  }
+}
+
+async function loadPatterns() {
+  const text = await (await fetch('/api/patterns')).text();
+  for (const name of text.split('\n').filter(Boolean)) {
+    $('pattern').add(new Option(name, name));
+  }
+}
+
+function scene() {
+  const q = new URLSearchParams({ pattern: $('pattern').value, bright: $('bright').value });
+  fetch('/api/scene?' + q);
+}
+
+function listen() {
+  const es = new EventSource('/api/events');
+  es.addEventListener('button', (ev) => {
+    const d = JSON.parse(ev.data);
+    const li = document.createElement('li');
+    li.textContent = `Botão ${d.button}: ${d.gesture}`;
+    $('events').prepend(li);
+    while ($('events').children.length > 6) {
+      $('events').lastChild.remove();
+    }
+    refresh();
+  });
+}
+
+// Temperatura média por minuto (colunas t, temp_min, temp_avg, ...)
+async function drawHistory() {
+  const csv = await (await fetch('/api/history?res=1m', { cache: 'no-store' })).text();
+  const rows = csv.trim().split('\n').slice(1).map((l) => l.split(',').map(Number));
+  const cv = $('chart');
+  const g = cv.getContext('2d');
+  g.clearRect(0, 0, cv.width, cv.height);
+  if (rows.length < 2) {
+    return;
+  }
+  const vals = rows.map((r) => r[2]);
+  const lo = Math.min(...vals) - 0.5;
+  const hi = Math.max(...vals) + 0.5;
+  g.strokeStyle = '#2f9e6e';
+  g.lineWidth = 2;
+  g.beginPath();
+  vals.forEach((v, i) => {
+    const x = (i / (vals.length - 1)) * cv.width;
+    const y = cv.height - ((v - lo) / (hi - lo)) * cv.height;
+    i ? g.lineTo(x, y) : g.moveTo(x, y);
+  });
+  g.stroke();
+  g.fillStyle = '#8b98a5';
+  g.fillText(hi.toFixed(1) + ' °C', 4, 12);
+  g.fillText(lo.toFixed(1) + ' °C', 4, cv.height - 4);
+}
+
+$('led').addEventListener('change', (e) => action(e.target.checked ? '/led/on' : '/led/off'));
+$('update').addEventListener('click', () => action('/update'));
+$('pattern').addEventListener('change', scene);
+$('bright').addEventListener('change', scene);
+
+refresh();
+loadPatterns();
+listen();
+drawHistory();
+setInterval(refresh, STATUS_MS);
+setInterval(drawHistory, HISTORY_MS);